@@ -0,0 +1,95 @@
+#ifndef ARCADE_ASSETLOADER_HPP
+#define ARCADE_ASSETLOADER_HPP
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "threadPool.hpp"
+
+namespace arcader {
+
+    /**
+     * @brief Loads assets in the background and finishes them on the render thread under a time budget.
+     *
+     * Every step has an optional prepare part (file I/O, decoding, parsing) running on a worker thread and a
+     * finish part (GL uploads, registration) running on the render thread. Finish parts run strictly in the
+     * order the steps were queued, so a step may rely on everything queued before it.
+     */
+    class AssetLoader {
+    public:
+        explicit AssetLoader(unsigned threadCount = ThreadPool::defaultThreadCount()) : pool(threadCount) {}
+
+        AssetLoader(const AssetLoader &) = delete;
+        AssetLoader &operator=(const AssetLoader &) = delete;
+
+        /**
+         * Queue a step with a worker part.
+         * @param prepare runs on a worker thread, must not touch GL or shared state
+         * @param finish runs on the render thread with the result of prepare
+         */
+        template<typename T>
+        void enqueue(std::function<T()> prepare, std::function<void(T &)> finish) {
+            auto slot = std::make_shared<Slot<T>>();
+            pool.submit([slot, prepare = std::move(prepare)] {
+                slot->value = prepare();
+                slot->ready.store(true, std::memory_order_release);
+            });
+            steps.push_back({
+                [slot] { return slot->ready.load(std::memory_order_acquire); },
+                [slot, finish = std::move(finish)] { finish(slot->value); }
+            });
+            ++total;
+        }
+
+        /**
+         * Queue a step that only runs on the render thread, after all steps queued before it.
+         */
+        void enqueue(std::function<void()> finish) {
+            steps.push_back({[] { return true; }, std::move(finish)});
+            ++total;
+        }
+
+        /**
+         * Finish prepared steps in order until the budget is used up, at least one step runs if it is ready.
+         * @param budgetMs render thread time to spend
+         * @return true if nothing is left to load
+         */
+        bool update(double budgetMs);
+
+        /**
+         * Block until every queued step is finished.
+         */
+        void finishAll();
+
+        [[nodiscard]] bool isIdle() const { return steps.empty(); }
+
+        /**
+         * @return Finished fraction of all steps queued so far, 1 when idle
+         */
+        [[nodiscard]] float getProgress() const {
+            return total == 0 ? 1.0f : static_cast<float>(finished) / static_cast<float>(total);
+        }
+
+    private:
+        template<typename T>
+        struct Slot {
+            T value;
+            std::atomic<bool> ready{false};
+        };
+
+        struct Step {
+            std::function<bool()> ready;
+            std::function<void()> finish;
+        };
+
+        std::deque<Step> steps;
+        size_t total = 0;
+        size_t finished = 0;
+        ThreadPool pool; // declared last so it is joined before the steps its jobs fill are destroyed
+    };
+
+} // arcader
+
+#endif //ARCADE_ASSETLOADER_HPP
@@ -5,19 +5,29 @@
 #ifndef ARCADE_ASSETMANAGER_HPP
 #define ARCADE_ASSETMANAGER_HPP
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <framework/mesh.hpp>
 #include <framework/gl/program.hpp>
-#include <framework/gl/texture.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "assetLoader.hpp"
+#include "cookedMesh.hpp"
+#include "cookedTexture.hpp"
+#include "staticAssets.hpp"
+#include "staticMesh.hpp"
+#include "texture2D.hpp"
+#include "uniformCache.hpp"
+
 namespace arcader {
 
     struct RenderableAsset {
-        Mesh *mesh;
+        StaticMesh *mesh;
         Program *shader;
-        std::vector<Texture<GL_TEXTURE_2D> *> textures;
+        UniformCache *uniforms;
+        std::vector<Texture2D *> textures;
         std::vector<Mesh::VertexPTN> vertices;
         std::vector<unsigned int> indices;
         GLuint triangleCount;
@@ -27,55 +37,29 @@ namespace arcader {
                     const glm::vec3 &scale = glm::vec3(1.0f)) const {
             glm::mat4 model = glm::translate(glm::mat4(1.0f), position) *
                               glm::scale(glm::mat4(1.0f), scale);
-            glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
 
             shader->use();
-            shader->set("uWorldToClip", worldToClip);
-            shader->set("uModelMatrix", model);
-            shader->set("uNormalMatrix", normalMatrix);
+            uniforms->set("uWorldToClip", worldToClip);
+            uniforms->set("uModelMatrix", model);
 
+            // Samplers tex0, tex1, ... are assigned to their units once in AssetManager::registerRenderable
             for (size_t i = 0; i < textures.size(); ++i) {
                 textures[i]->bindTextureUnit(static_cast<GLuint>(i));
-                shader->bindTextureUnit("tex" + std::to_string(i), static_cast<GLint>(i));
             }
 
             mesh->draw();
-            glBindVertexArray(0);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
         }
     };
 
-    enum class StaticAssets {
-        MISSING_TEXTURE,
-
-        BLOCK_GRASS,
-        BLOCK_DIRT,
-        BLOCK_WOOD,
-        BLOCK_LEAVES,
-        BLOCK_STONE,
-        BLOCK_WATER,
-        BLOCK_AIR,
-        PLAYER_IDLE,
-        PLAYER_WALK1,
-        PLAYER_WALK2,
-        PLAYER_WALK3,
-        PLAYER_MINE,
-        HUD_SLOT,
-        BACKGROUND,
-
-        SHADER_TILE,
-        SHADER_ENTITY,
-        SHADER_DEBUG,
-        SHADER_HUD,
-
-        ARCADE_MACHINE,
-        ARCADE_MACHINE_2,
-        ARCADE_MACHINE_3,
-        ARCADE_MACHINE_4,
-        ARCADE_MACHINE_5,
-        ROOM
+    /**
+     * @brief Variants of a renderable that share mesh and program and only differ in their texture,
+     * drawn together with one instanced draw call. Layer i of the texture array is the texture of variant i.
+     */
+    struct InstancedAsset {
+        StaticMesh *mesh;
+        Program *shader;
+        UniformCache *uniforms;
+        GLuint textureArray = 0;
     };
 
     class AssetManager {
@@ -83,8 +67,17 @@ namespace arcader {
         Program program;
 
     public:
+        /**
+         * Load a mesh under a name. Meshes are shared by contents: a file loaded before under any name or path is
+         * not uploaded again, so renderables that only differ in textures use the same buffers.
+         * OBJ files are read through their cooked binary version, see CookedMesh.
+         */
         void loadMesh(const StaticAssets &name, const std::string &filepath);
 
+        /**
+         * Load a shader program under a name. Programs are shared by source: if the same vertex and fragment
+         * shader were loaded before under any name, that program is reused instead of compiled again.
+         */
         void loadShader(const StaticAssets &name, const std::string &vertexPath, const std::string &fragmentPath);
 
         AssetManager();
@@ -92,12 +85,43 @@ namespace arcader {
         void loadTexture(const StaticAssets &name, const std::filesystem::path &filepath,
                          GLenum internalFormat = GL_SRGB8_ALPHA8, GLint mipmaps = 0);
 
-        const Texture<GL_TEXTURE_2D> &getTexture(const StaticAssets &name) const;
+        /**
+         * Load a texture as S3TC blocks with a precomputed mip chain, cooked from the image on first use
+         * (see CookedTexture). Falls back to loadTexture for formats other than GL_SRGB8_ALPHA8 and GL_RGBA8 or if
+         * the image is missing.
+         */
+        void loadCompressedTexture(const StaticAssets &name, const std::filesystem::path &filepath,
+                                   GLenum internalFormat = GL_SRGB8_ALPHA8, GLint mipmaps = 0);
+
+        const Texture2D &getTexture(const StaticAssets &name) const;
+
+        /**
+         * Packs sprite images into a single GL_TEXTURE_2D_ARRAY, one layer per image.
+         * All layers share the size of the largest image, smaller images are scaled up with nearest filtering
+         * so pixel art stays sharp. Images with the same path share a layer.
+         * @param sprites Asset names and image paths to pack
+         */
+        void loadSpriteArray(const std::vector<std::pair<StaticAssets, std::filesystem::path>> &sprites);
+
+        /**
+         * @return GL handle of the sprite array texture, 0 if not loaded
+         */
+        GLuint getSpriteArray() const { return spriteArray; }
 
-        const Mesh &getMesh(const StaticAssets &name) const;
+        /**
+         * Lookup the layer of a packed sprite, falls back to the missing texture layer.
+         */
+        GLint getSpriteLayer(const StaticAssets &name) const;
+
+        const StaticMesh &getMesh(const StaticAssets &name) const;
 
         Program &getShader(const StaticAssets &name);
 
+        /**
+         * @return Uniform locations of a shader loaded with loadShader, valid as long as the asset manager lives
+         */
+        UniformCache &getUniforms(const StaticAssets &name);
+
         RenderableAsset getRenderable(const StaticAssets &name) const;
 
         void registerRenderable(const StaticAssets &name, const StaticAssets &meshName,
@@ -114,6 +138,73 @@ namespace arcader {
 
         bool hasRenderable(const StaticAssets &name) const;
 
+        /**
+         * Queue a texture load: the image is decoded on a worker thread and uploaded in updateLoading.
+         */
+        void loadTextureAsync(const StaticAssets &name, const std::filesystem::path &filepath,
+                              GLenum internalFormat = GL_SRGB8_ALPHA8, GLint mipmaps = 0);
+
+        /**
+         * Queue loadCompressedTexture: the cooked file is mapped (or cooked) on a worker thread.
+         */
+        void loadCompressedTextureAsync(const StaticAssets &name, const std::filesystem::path &filepath,
+                                        GLenum internalFormat = GL_SRGB8_ALPHA8, GLint mipmaps = 0);
+
+        /**
+         * Queue loadSpriteArray: images are decoded and scaled on a worker thread, the array is uploaded in
+         * updateLoading.
+         */
+        void loadSpriteArrayAsync(const std::vector<std::pair<StaticAssets, std::filesystem::path>> &sprites);
+
+        /**
+         * Queue loadRenderable: mesh parsing and image decoding run on worker threads, shader compilation,
+         * uploads and the registration run in updateLoading. The renderable exists once all of them finished.
+         */
+        void loadRenderableAsync(const StaticAssets &name,
+                                 const std::filesystem::path &meshPath,
+                                 const std::filesystem::path &vertexShader,
+                                 const std::filesystem::path &fragmentShader,
+                                 const std::vector<std::filesystem::path> &texturePaths,
+                                 GLenum internalFormat = GL_SRGB8_ALPHA8,
+                                 GLint mipmaps = 0);
+
+        /**
+         * Run a task on the render thread once everything queued before it is loaded,
+         * e.g. setting uniforms or registering instanced groups of the loaded assets.
+         */
+        void whenLoaded(std::function<void()> task) { loader.enqueue(std::move(task)); }
+
+        /**
+         * Finish queued loads on the render thread, call once per frame.
+         * @param budgetMs render thread time to spend on uploads this frame
+         * @return true if all queued assets are loaded
+         */
+        bool updateLoading(double budgetMs) { return loader.update(budgetMs); }
+
+        /**
+         * @return Loaded fraction of all queued assets, 1 when nothing is pending
+         */
+        float getLoadingProgress() const { return loader.getProgress(); }
+
+        /**
+         * Group renderables for instanced drawing. All variants must share mesh and shader, their first textures
+         * are copied into the layers of one texture array in the given order and must have the same size.
+         * @param name name of the group for renderInstanced
+         * @param variants registered renderables, variant i is drawn by instances with layer i
+         */
+        void registerInstanced(const StaticAssets &name, const std::vector<StaticAssets> &variants);
+
+        bool hasInstanced(const StaticAssets &name) const { return instanced.contains(name); }
+
+        /**
+         * Draw all instances of a group registered with registerInstanced in one draw call.
+         * The shader gets `uInstanced = true` and the texture array on unit INSTANCE_TEXTURE_UNIT.
+         */
+        void renderInstanced(const StaticAssets &name, const glm::mat4 &worldToClip,
+                             const InstanceBuffer &instances);
+
+        static constexpr GLint INSTANCE_TEXTURE_UNIT = 2; // units 0 and 1 are the material and the shadow map
+
         void render(const StaticAssets &asset,
                     const glm::mat4 &worldToClip,
                     const glm::vec3 &position = glm::vec3(0.0f),
@@ -130,10 +221,65 @@ namespace arcader {
 
 
     private:
-        std::unordered_map<StaticAssets, Mesh> meshes;
-        std::unordered_map<StaticAssets, Program> shaders;
-        std::unordered_map<StaticAssets, Texture<GL_TEXTURE_2D>> textures;
+        /**
+         * Sprites scaled to a common layer size, built on a worker thread by packSprites.
+         */
+        struct SpriteSheet {
+            int layerSize = 1;
+            GLsizei layerCount = 0;
+            std::vector<unsigned char> pixels; // layerCount layers of layerSize² RGBA8 pixels
+            std::unordered_map<StaticAssets, GLint> layers;
+        };
+
+        /**
+         * Texture read on a worker thread: cooked blocks if available, otherwise the decoded image.
+         */
+        struct TextureSource {
+            CookedTexture cooked;
+            DecodedImage image;
+        };
+
+        static TextureSource readTexture(const std::filesystem::path &filepath, GLenum internalFormat);
+
+        void uploadTexture(const StaticAssets &name, const TextureSource &source, GLenum internalFormat,
+                           GLint mipmaps);
+
+        static SpriteSheet packSprites(const std::vector<std::pair<StaticAssets, std::filesystem::path>> &sprites);
+
+        void uploadSpriteArray(SpriteSheet &sheet);
+
+        /**
+         * Names the textures of a renderable after the renderable: texture i is name + i + 1.
+         */
+        static StaticAssets textureName(const StaticAssets &name, size_t index);
+
+        static std::string meshPathKey(const std::filesystem::path &path);
+
+        /**
+         * Upload a loaded mesh unless one with the same contents exists already.
+         * @return the mesh of the contents
+         */
+        StaticMesh &addMesh(const std::string &path, const CookedMesh &cooked);
+
+        std::unordered_map<uint64_t, StaticMesh> meshFiles;     // keyed by the cache key of their contents
+        std::unordered_map<std::string, uint64_t> meshPaths;    // normalized path to contents
+        std::unordered_set<std::string> pendingMeshFiles;       // queued for async loading, not uploaded yet
+        std::unordered_map<StaticAssets, StaticMesh *> meshes;
+        struct ShaderProgram {
+            Program program;
+            UniformCache uniforms;
+        };
+
+        std::unordered_map<std::string, ShaderProgram> programs; // keyed by vertex and fragment path
+        std::unordered_map<StaticAssets, ShaderProgram *> shaders;
+        std::unordered_map<StaticAssets, Texture2D> textures;
         std::unordered_map<StaticAssets, RenderableAsset> renderables;
+        std::unordered_map<StaticAssets, InstancedAsset> instanced;
+
+        GLuint spriteArray = 0;
+        std::unordered_map<StaticAssets, GLint> spriteLayers;
+
+        AssetLoader loader; // declared last so pending worker jobs are joined before anything else is destroyed
     };
 
 
@@ -5,22 +5,27 @@
 #ifndef ARCADE_AUDIOPLAYER_HPP
 #define ARCADE_AUDIOPLAYER_HPP
 
-#include <iostream>
 #include <memory>
-#include <unordered_map>
-#include "miniaudio.h"
+#include <string>
 
 
 class AudioPlayer {
 public:
+    AudioPlayer();
+    ~AudioPlayer();
+
+    /**
+     * Open the audio device. Without it (e.g. headless) playing sounds does nothing.
+     */
     void init();
     void play(const std::string& filename, float volume = 1.0f);
     void stop(const std::string& filename);
     bool isPlaying(const std::string& filename) const;
 
 private:
-    ma_engine engine;
-    std::unordered_map<std::string, std::unique_ptr<ma_sound>> sounds;
+    // Audio engine and loaded sounds, defined by the audio backend (audioPlayer.cpp, or the silent headlessAudio.cpp)
+    struct Device;
+    std::unique_ptr<Device> device; // null until init succeeds
 };
 
 
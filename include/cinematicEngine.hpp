@@ -12,6 +12,8 @@
 #include "game/gameManager.hpp"
 #include "dustParticles.hpp"
 #include "audioPlayer.hpp"
+#include "uniformBuffer.hpp"
+#include "uniformCache.hpp"
 
 /**
  * @brief Controls cinematic sequences including timed camera movement and rendering transitions.
@@ -26,9 +28,21 @@ namespace arcader {
     public:
         explicit CinematicEngine(AssetManager *assetManager, GameManager *gameManager);
 
+        /**
+         * Advance the current scene by one fixed simulation step.
+         */
         void update(float deltaTime);
 
-        void render();
+        /**
+         * Render the current scene.
+         * @param alpha progress between the previous and the latest simulation step, used to interpolate movement
+         */
+        void render(float alpha = 1.0f);
+
+        /**
+         * Queue the arcade room assets on the asset manager, they are loaded before the first frame is shown.
+         */
+        void preload();
 
         void reset();
 
@@ -45,16 +59,35 @@ namespace arcader {
         void renderSkybox();
 
         void initShadow();
+
+        /**
+         * Render the shadow casters into every cascade of the shadow map, fitted to the current view.
+         */
         void renderShadowPass();
 
+        /**
+         * Build the instances of the arcade machine arrangement and of the shadow casters and upload them once.
+         * @param machines variants in the order of their texture array layers
+         */
+        void placeMachines(const std::vector<StaticAssets> &machines);
+
         const int windowWidth = 1280;
         const int windowHeight = 720;
+        uint64_t arrangementSeed = 0; // seed of the arcade machine arrangement, same seed gives the same room
+        InstanceBuffer machineInstances;
+        InstanceBuffer shadowInstances;
         Mesh mesh;
 
     private:
         void updateScene(int state, float dt);
 
-        void renderScene(int state);
+        void renderScene(int state, float alpha);
+
+        /**
+         * Split the view frustum up to SHADOW_DISTANCE into the cascades and fit a light projection to each slice.
+         * A projection only moves in whole shadow map texels and keeps its size, so shadow edges do not swim.
+         */
+        void fitCascades();
 
         int state = 0;
         float timer = 0.0f;
@@ -68,19 +101,23 @@ namespace arcader {
         AssetManager *assets;
         GameManager *game;
         Camera camera;
+        UniformBuffer<CameraBlock> cameraBuffer{UniformBlock::CAMERA};
         LightingSystem lighting;
         DustParticles dustParticles;
 
         Program dustShader;
+        UniformCache dustUniforms;
         GLuint dustTexture;
 
         AudioPlayer audioPlayer;
 
         GLuint depthMapFBO;
-        GLuint depthMap;
-        Program depthShader;
-        glm::mat4 lightSpaceMatrix;
-        const GLuint SHADOW_WIDTH = 8192, SHADOW_HEIGHT = 8192;
+        GLuint depthMap; // texture array, one layer per cascade
+        LightingSystem::ShadowCascades cascades{};
+        static constexpr GLsizei SHADOW_SIZE = 2048;         // resolution of every cascade
+        static constexpr float SHADOW_DISTANCE = 30.0f;      // view depth covered by the cascades
+        static constexpr float SHADOW_SPLIT_BLEND = 0.75f;   // 0 splits uniformly, 1 logarithmically
+        static constexpr float SHADOW_CASTER_MARGIN = 20.0f; // casters in front of a slice still cast into it
     };
 
 }
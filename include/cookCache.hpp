@@ -0,0 +1,44 @@
+#ifndef ARCADE_COOKCACHE_HPP
+#define ARCADE_COOKCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace arcader {
+
+    /**
+     * @brief Content addressed store of cooked assets in cache/.
+     *
+     * An artefact is stored under a key hashed from the contents of its sources and every parameter the result
+     * depends on (at least the cook version), e.g. `Random::hash(*hashFile(source), VERSION)`. Changing a source,
+     * a parameter or the cook code gives a new key, so stale artefacts are never read and need no invalidation.
+     * Equal sources share one artefact no matter where they are stored.
+     */
+    class CookCache {
+    public:
+        /**
+         * Hash the contents of a file, reading it through a memory mapping.
+         * @return nothing if the file cannot be read
+         */
+        static std::optional<uint64_t> hashFile(const std::filesystem::path &path);
+
+        static uint64_t hashBytes(const void *data, size_t size);
+
+        /**
+         * @return Path of the artefact with a key, cache/<key as hex>.<extension>
+         */
+        static std::filesystem::path cookedPath(uint64_t key, const char *extension);
+
+        /**
+         * Write through a temporary file, so a crash or a second instance never sees a half written file.
+         * @return false if the file could not be written
+         */
+        static bool write(const std::filesystem::path &cooked, const std::vector<std::byte> &bytes);
+    };
+
+} // arcader
+
+#endif //ARCADE_COOKCACHE_HPP
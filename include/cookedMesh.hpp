@@ -0,0 +1,100 @@
+#ifndef ARCADE_COOKEDMESH_HPP
+#define ARCADE_COOKEDMESH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include "mappedFile.hpp"
+#include "staticMesh.hpp"
+
+namespace arcader {
+
+    /**
+     * @brief Header of a cooked mesh file, followed by the interleaved vertices and then the indices.
+     *
+     * All values are little endian. Vertices are MeshVertex (same layout as Mesh::VertexPTN), indices are 16 bit
+     * if every vertex can be addressed with 16 bits and 32 bit otherwise.
+     */
+    struct CookedMeshHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexSize; // bytes per index, 2 or 4
+        MeshBounds bounds;
+    };
+
+    /**
+     * @brief Mesh in the cooked binary format, ready to be uploaded without any parsing.
+     *
+     * OBJ files are cooked once into the CookCache and memory mapped on later launches. The cache key is the hash
+     * of the OBJ contents, so edited meshes are cooked again.
+     */
+    class CookedMesh {
+    public:
+        static constexpr char MAGIC[4] = {'A', 'M', 'S', 'H'};
+        static constexpr uint32_t VERSION = 1;
+
+        /**
+         * Open the cooked version of an OBJ file, cooking it first if it is not in the cache yet.
+         * Safe to call from worker threads. If the cooked file cannot be written, the freshly cooked data is
+         * used from memory.
+         * @return false if the OBJ file could not be read
+         */
+        bool load(const std::filesystem::path &objPath);
+
+        /**
+         * Cook an OBJ file into the cache, even if it is there already.
+         * @return false if the OBJ could not be read or the cache file could not be written
+         */
+        static bool cook(const std::filesystem::path &objPath);
+
+        /**
+         * @return Cache key of an OBJ file, nothing if it cannot be read
+         */
+        static std::optional<uint64_t> cacheKey(const std::filesystem::path &objPath);
+
+        /**
+         * Encode mesh data in the cooked format.
+         */
+        static std::vector<std::byte> encode(const MeshData &data);
+
+        [[nodiscard]] const MeshVertex *getVertices() const { return vertices; }
+        [[nodiscard]] const void *getIndices() const { return indices; }
+        [[nodiscard]] GLsizei getVertexCount() const { return vertexCount; }
+        [[nodiscard]] GLsizei getIndexCount() const { return indexCount; }
+        [[nodiscard]] GLenum getIndexType() const { return indexType; }
+        [[nodiscard]] const MeshBounds &getBounds() const { return bounds; }
+
+        /**
+         * @return Cache key of the loaded mesh, meshes loaded from equal files have equal keys
+         */
+        [[nodiscard]] uint64_t getKey() const { return key; }
+
+    private:
+        /**
+         * Point the accessors into a cooked file image after validating it.
+         * @return false if the image is truncated, of another version or not a cooked mesh
+         */
+        bool view(const std::byte *data, size_t size);
+
+        MappedFile file;
+        std::vector<std::byte> image; // cooked in memory, used if the file could not be written
+
+        const MeshVertex *vertices = nullptr;
+        const void *indices = nullptr;
+        GLsizei vertexCount = 0;
+        GLsizei indexCount = 0;
+        GLenum indexType = GL_UNSIGNED_INT;
+        MeshBounds bounds;
+        uint64_t key = 0;
+    };
+
+} // arcader
+
+#endif //ARCADE_COOKEDMESH_HPP
@@ -0,0 +1,86 @@
+#ifndef ARCADE_COOKEDTEXTURE_HPP
+#define ARCADE_COOKEDTEXTURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "mappedFile.hpp"
+#include "texture2D.hpp"
+
+namespace arcader {
+
+    /**
+     * @brief Block compressed texture with a precomputed mip chain, cooked from an image file.
+     *
+     * Images are cooked once into the CookCache as DDS files: BC1 (DXT1) for opaque images, BC3 (DXT5) if any
+     * texel is transparent. Mip levels are box filtered in linear space, so the texels are assumed to be sRGB
+     * encoded colors. Rows are stored bottom up like GL expects, other DDS viewers show the image upside down.
+     */
+    class CookedTexture {
+    public:
+        enum class Format {
+            BC1, // 8 bytes per 4x4 block, opaque
+            BC3  // 16 bytes per 4x4 block, BC1 colors plus interpolated alpha
+        };
+
+        struct Level {
+            int width;
+            int height;
+            const std::byte *blocks;
+            size_t size;
+        };
+
+        static constexpr uint32_t VERSION = 1;
+
+        /**
+         * Open the cooked version of an image, cooking it first if it is not in the cache yet.
+         * Safe to call from worker threads.
+         * @return false if the image could not be read
+         */
+        bool load(const std::filesystem::path &imagePath);
+
+        /**
+         * Cook an image into the cache, even if it is there already.
+         * @return false if the image could not be read or the cache file could not be written
+         */
+        static bool cook(const std::filesystem::path &imagePath);
+
+        /**
+         * @return Cache key of an image file, nothing if it cannot be read
+         */
+        static std::optional<uint64_t> cacheKey(const std::filesystem::path &imagePath);
+
+        /**
+         * Build the mip chain of an image and compress it into a DDS file image.
+         */
+        static std::vector<std::byte> encode(const DecodedImage &image);
+
+        /**
+         * Decompress one mip level on the CPU, for drivers without S3TC support and for testing.
+         */
+        [[nodiscard]] DecodedImage decode(size_t level) const;
+
+        [[nodiscard]] bool isLoaded() const { return !levels.empty(); }
+        [[nodiscard]] Format getFormat() const { return format; }
+        [[nodiscard]] const std::vector<Level> &getLevels() const { return levels; }
+
+    private:
+        /**
+         * Point the levels into a DDS file image after validating it.
+         * @return false if the image is truncated, of another cook version or not a cooked texture
+         */
+        bool view(const std::byte *data, size_t size);
+
+        MappedFile file;
+        std::vector<std::byte> image; // cooked in memory, used if the file could not be written
+
+        Format format = Format::BC1;
+        std::vector<Level> levels;
+    };
+
+} // arcader
+
+#endif //ARCADE_COOKEDTEXTURE_HPP
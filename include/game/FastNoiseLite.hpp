@@ -52,6 +52,8 @@
 
 #include <cmath>
 
+namespace arcader { class FastNoiseBatch; } // Arcade
+
 class FastNoiseLite
 {
 public:
@@ -394,6 +396,9 @@ public:
     }
 
 private:
+    // Arcade: vectorized batch evaluation needs the settings and lookup tables (see fastNoiseBatch.hpp)
+    friend class arcader::FastNoiseBatch;
+
     template <typename T>
     struct Arguments_must_be_floating_point_values;
 
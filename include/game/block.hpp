@@ -4,16 +4,25 @@
 
 #ifndef STATES_H
 #define STATES_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
 #include <vector>
 
-#include "assetManager.hpp"
+#include <glm/glm.hpp>
+
+#include "staticAssets.hpp"
 
 namespace arcader {
+class BlockScheduler;
+class World;
+
 /**
  * Block type for each block in the world.
  * Important for rendering and distinction of blocks.
+ * Stored as a single byte per cell in the world.
  */
-enum class BlockType {
+enum class BlockType : uint8_t {
     GRASS,
     DIRT,
     WOOD,
@@ -25,21 +34,9 @@ enum class BlockType {
 };
 
 /**
- * Holder struct for all information a block can have.
- * This is mainly for the block type, but maybe blocks will have some states, like water later.
+ * Number of block types, used to size per-type lookup tables.
  */
-struct Block {
-    BlockType type;
-    StaticAssets texture;
-};
-
-/**
- * Holder struct for block updates that are scheduled to be applied.
- */
-struct BlockUpdate {
-    BlockType type;
-    glm::uvec2 position;
-};
+constexpr size_t BLOCK_TYPE_COUNT = static_cast<size_t>(BlockType::AIR) + 1;
 
 class BlockStates {
 public:
@@ -66,20 +63,34 @@ public:
      */
     static bool isSolid(const BlockType &type);
 
+    /**
+     * Number of game ticks a block waits before its scheduled update runs after a change nearby.
+     * @return 0 if the block type never updates
+     */
+    static uint32_t getTickDelay(const BlockType &type);
+
+    /**
+     * Run the scheduled update of a block, depending on its current type.
+     * @param world Blocks in world
+     * @param pos block position, must be loaded
+     * @param scheduler receives the updates caused by this one
+     */
+    static void update(World &world, glm::ivec2 pos, BlockScheduler &scheduler);
+
     /**
      * Checks if a position collides with any solid blocks in the world.
      */
-    static bool isColliding(const glm::vec2& pos, const std::vector<std::vector<Block>>& blocks);
+    static bool isColliding(const glm::vec2& pos, const World& world);
 
     /**
      * Get the first block from top to bottom that is not air.
      * @param ignoreLeaves Useful for placing the player under trees, not on top
      * @param x X coordinate in world
-     * @param blocks Blocks in world
+     * @param world Blocks in world
      */
-    static int getHighestBlock(bool ignoreLeaves, int x, const std::vector<std::vector<Block>>& blocks);
+    static int getHighestBlock(bool ignoreLeaves, int x, const World& world);
 
-    static bool isInBounds(glm::uvec2 pos, const std::vector<std::vector<Block>>& blocks);
+    static bool isInBounds(glm::ivec2 pos, const World& world);
 };
 } // arcader
 
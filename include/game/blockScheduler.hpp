@@ -0,0 +1,101 @@
+#ifndef BLOCKSCHEDULER_HPP
+#define BLOCKSCHEDULER_HPP
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "world.hpp"
+
+namespace arcader {
+/**
+ * Queue of block updates that are due after a number of game ticks.
+ * Each position is pending at most once, scheduling it again while it waits is ignored. Due updates run in a
+ * fixed order (due tick, then bottom to top, then left to right) and at most a budget of them per call,
+ * the rest stays due and runs first on the next call. All storage is reused, nothing is allocated once
+ * the queue has grown to its working size.
+ */
+class BlockScheduler {
+public:
+    /**
+     * Schedule an update of a position.
+     * @param pos block position
+     * @param delay number of ticks until the update is due, at least 1
+     */
+    void schedule(glm::ivec2 pos, uint32_t delay);
+
+    /**
+     * Schedule a changed block and its direct neighbours, each with the tick delay of its block type.
+     * Block types without a tick delay are skipped.
+     */
+    void scheduleNeighbourhood(const World &world, glm::ivec2 pos);
+
+    /**
+     * Advance the tick counter by one game tick.
+     */
+    void advance() { ++currentTick; }
+
+    /**
+     * Take the next update that is due, it is no longer pending afterwards and can be scheduled again.
+     * @param pos receives the block position
+     * @return false if no update is due
+     */
+    bool popDue(glm::ivec2 &pos);
+
+    /**
+     * Drop all pending updates, e.g. when the world is regenerated.
+     */
+    void clear();
+
+    /**
+     * Drop the pending updates of one chunk column, e.g. when it is unloaded.
+     */
+    void clearColumn(int chunkX);
+
+    [[nodiscard]] uint32_t getTick() const { return currentTick; }
+
+    /**
+     * @return Number of pending updates, due or not.
+     */
+    [[nodiscard]] size_t getPendingCount() const { return queue.size(); }
+
+private:
+    struct Entry {
+        uint32_t due;
+        int y;
+        int x;
+    };
+
+    /**
+     * Min-heap order of the queue, later entries compare as smaller priority.
+     */
+    static bool later(const Entry &a, const Entry &b) {
+        if (a.due != b.due) return a.due > b.due;
+        if (a.y != b.y) return a.y > b.y;
+        return a.x > b.x;
+    }
+
+    static uint64_t key(const int x, const int y) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+    }
+
+    [[nodiscard]] size_t home(const uint64_t k) const {
+        return static_cast<size_t>(k * 0x9E3779B97F4A7C15ull >> 32) & (pending.size() - 1);
+    }
+
+    // Open addressing set of pending positions with linear probing
+    [[nodiscard]] size_t probe(uint64_t k) const;
+    bool insertPending(uint64_t k);
+    void erasePending(uint64_t k);
+    void growPending();
+
+    static constexpr uint64_t EMPTY = UINT64_MAX; // key(-1, -1), never a valid position since y >= 0
+
+    std::vector<Entry> queue;
+    std::vector<uint64_t> pending;
+    size_t pendingCount = 0;
+    uint32_t currentTick = 0;
+};
+} // arcader
+
+#endif //BLOCKSCHEDULER_HPP
@@ -4,11 +4,15 @@
 
 #ifndef ENTITY_HPP
 #define ENTITY_HPP
-#include "assetManager.hpp"
+#include <glm/glm.hpp>
+
 #include "audioPlayer.hpp"
 #include "block.hpp"
+#include "staticAssets.hpp"
+#include "world.hpp"
 
 namespace arcader {
+class AssetManager;
 
 enum class EntityType {
     PLAYER,
@@ -30,6 +34,7 @@ protected:
 
 public:
     glm::vec2 position;
+    glm::vec2 previousPosition; // position before the last simulation step, used to interpolate rendering
     glm::vec2 velocity;
 
     Entity(EntityType type, float width, float height, const glm::vec2& position, StaticAssets startSprite);
@@ -40,10 +45,10 @@ public:
      * Pure virtual function for updating the entity's state.
      * Must be implemented by derived classes.
      * @param deltaTime Time elapsed since the last update.
-     * @param blocks all blocks
+     * @param world all blocks
      * @param audioPlayer Reference to the AudioPlayer for playing sounds.
      */
-    virtual void update(float deltaTime, const std::vector<std::vector<Block>>& blocks, AudioPlayer& audioPlayer) = 0;
+    virtual void update(float deltaTime, const World& world, AudioPlayer& audioPlayer) = 0;
 
     /**
      * Pure virtual function for rendering the entity.
@@ -53,6 +58,14 @@ public:
      */
     virtual void render(const glm::mat4 &worldToClip, AssetManager *assets) const {}
 
+    /**
+     * Position to draw the entity at between two simulation steps.
+     * @param alpha progress from the previous step (0) to the current one (1)
+     */
+    [[nodiscard]] glm::vec2 getRenderPosition(const float alpha) const {
+        return glm::mix(previousPosition, position, alpha);
+    }
+
     [[nodiscard]] virtual EntityType getType() const { return type; }
     [[nodiscard]] virtual float getWidth() const { return width; }
     [[nodiscard]] virtual float getHeight() const { return height; }
@@ -88,7 +101,7 @@ public:
     explicit EntityPlayer(const glm::vec2& position)
         : Entity(EntityType::PLAYER, 0.6f, 1.35f, position, StaticAssets::PLAYER_IDLE) {}
 
-    void update(float deltaTime, const std::vector<std::vector<Block>>& blocks, AudioPlayer& audioPlayer) override;
+    void update(float deltaTime, const World& world, AudioPlayer& audioPlayer) override;
 
     /**
      * Renders the player entity.
@@ -103,7 +116,7 @@ public:
      */
     [[nodiscard]] bool getDirection() const override;
 
-    [[nodiscard]] glm::uvec2 getTargetPosition() const;
+    [[nodiscard]] glm::ivec2 getTargetPosition() const;
 };
 
 } // arcader
@@ -0,0 +1,28 @@
+#ifndef FASTNOISEBATCH_HPP
+#define FASTNOISEBATCH_HPP
+#include <span>
+
+#include "FastNoiseLite.hpp"
+
+namespace arcader {
+/**
+ * Batch evaluation of 2D FastNoiseLite noise over many points at once.
+ * Perlin and OpenSimplex2 noise without fractals are evaluated 8 points at a time with SIMD
+ * (AVX2 or SSE picked at runtime where supported), every other configuration falls back to GetNoise.
+ * The results are bit-identical to calling FastNoiseLite::GetNoise for every point.
+ */
+class FastNoiseBatch {
+public:
+    /**
+     * Evaluate noise for every point, out[i] = noise.GetNoise(xs[i], ys[i]).
+     * @param noise configured noise generator
+     * @param xs x coordinates
+     * @param ys y coordinates, same size as xs
+     * @param out results, same size as xs
+     */
+    static void GetNoise(const FastNoiseLite &noise, std::span<const float> xs, std::span<const float> ys,
+                         std::span<float> out);
+};
+} // arcader
+
+#endif //FASTNOISEBATCH_HPP
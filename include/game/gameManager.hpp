@@ -4,13 +4,27 @@
 
 #ifndef GAMEMANAGER_H
 #define GAMEMANAGER_H
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
 #include "assetManager.hpp"
 #include "audioPlayer.hpp"
 #include "block.hpp"
 #include "entity.hpp"
+#include "terrainGenerator.hpp"
+#include "tileRenderer.hpp"
+#include "blockScheduler.hpp"
+#include "waterSimulation.hpp"
+#include "world.hpp"
 #include "framework/app.hpp"
 #include "framework/camera.hpp"
 #include "framework/gl/program.hpp"
+#include "lockFreeQueue.hpp"
+#include "threadPool.hpp"
+#include "uniformBuffer.hpp"
+#include "uniformCache.hpp"
 
 namespace arcader {
 struct RetroShaderData {
@@ -21,15 +35,74 @@ struct RetroShaderData {
     float scanlineFrequency = 0.25f;
 };
 
+/**
+ * std140 layout of the Retro block in game_tile.fsh, uploaded once per frame.
+ */
+struct RetroBlock {
+    RetroShaderData settings;
+    float time = 0.0f;
+    float padding[2]{};
+};
+static_assert(sizeof(RetroBlock) == 32);
+
 class GameManager {
-    static constexpr int worldWidth = 32;
+    static constexpr int viewWidth = 32; // blocks visible on the arcade screen
     static constexpr int worldHeight = 32;
+    static constexpr float spawnX = 16.5f;
+    static constexpr int loadRadius = 3; // chunk columns kept loaded on each side of the player
     /**
-     * World block grid with fix x and y size.
+     * Horizontally endless world, only the columns around the player are kept in memory.
      */
-    std::vector<std::vector<Block>> blocks;
+    World world{worldHeight, 2 * loadRadius + 1};
+    /**
+     * Directory of the spilled columns, private to this process so running instances do not share spill files.
+     * Removed with the game, after the workers (declared later) are joined.
+     */
+    struct SpillDirectory {
+        std::filesystem::path path;
+
+        SpillDirectory();
+        ~SpillDirectory();
+
+        SpillDirectory(const SpillDirectory &) = delete;
+        SpillDirectory &operator=(const SpillDirectory &) = delete;
+    } spillDirectory;
+
+    /**
+     * Column generated (or restored from disk) by a worker, waiting to be stored in the world.
+     */
+    struct GeneratedColumn {
+        int chunkX = 0;
+        uint32_t revision = 0;
+        std::vector<BlockType> blocks;
+        std::vector<uint8_t> levels; // fluid levels, empty for freshly generated columns
+    };
+    /**
+     * Modified column evicted from the world, written to disk by a worker.
+     */
+    struct SpilledColumn {
+        uint32_t revision = 0;
+        std::vector<BlockType> blocks;
+        std::vector<uint8_t> levels;
+    };
+    std::mutex spillMutex;
+    // Columns whose spill file is still being written, restored from here meanwhile. Guarded by spillMutex
+    std::unordered_map<int, std::shared_ptr<const SpilledColumn>> spillingColumns;
+    /**
+     * Copy a modified column that is about to be evicted and write it to disk on a worker thread.
+     * Until the file is complete, loading the column again restores it from the copy.
+     * @param chunkX loaded chunk column
+     */
+    void spillColumn(int chunkX);
+    std::shared_ptr<const TerrainGenerator> generator;
+    std::atomic<uint32_t> worldRevision{0}; // increased on every regeneration, results of older revisions are dropped
+    std::vector<std::pair<int, uint32_t>> pendingColumns; // requested chunk columns with their revision
+    LockFreeQueue<GeneratedColumn, 32> generatedColumns;
     static constexpr int blockDimension = 16;
-    std::vector<BlockUpdate> blockUpdates;
+    BlockScheduler blockScheduler;
+    static constexpr float tickLength = 0.05f; // seconds per game tick, block tick delays are counted in ticks
+    static constexpr int maxTicksPerFrame = 5;
+    std::vector<DirtyRegion> dirtyRegions; // block changes of all updates since the last rendered frame
 
     std::vector<std::unique_ptr<Entity>> entities;
 
@@ -43,59 +116,80 @@ class GameManager {
     Program& entityShader;
     Program& debugShader;
     Program& hudShader;
+    UniformCache& tileUniforms;
+    UniformCache& debugUniforms;
+    UniformBuffer<RetroBlock> retroBuffer{UniformBlock::RETRO};
     Mesh mesh;
+    TileRenderer tileRenderer;
+    QuadBatch sprites;
     EntityPlayer* player = nullptr;
     AudioPlayer audioPlayer;
+    ThreadPool workers; // declared last so it is joined before the data its jobs use is destroyed
 
     float startTime = 0.0f;
-    float blockUpdateDelay = 0.0f;
+    float tickTimer = 0.0f;
 
 public:
     GameManager(AssetManager *assetsManager, int *height, int *width);
 
     // World generation data
-    int seed = -1;
-    float frequency = 0.03f;
-    float terrainBase = 0.0f;
-    float terrainPeak = 100.0f;
-    float treeFrequency = 0.15f;
-    int waterLevel = 7;
+    TerrainSettings terrain;
+    bool randomSeed = true; // pick a new seed on init, otherwise the seed in terrain is kept for a reproducible world
     bool showHitboxes = false;
+    int blockUpdateBudget = 4096; // scheduled block updates per simulation step at most
     RetroShaderData retroShaderData;
 
+    /**
+     * Queue the game textures on the asset manager, they are loaded before the first frame is shown.
+     */
+    void preload();
+
     /**
      * Initializes the game world by loading mesh data.
      */
     void init();
 
     /**
-     * Generate the block terrain based on a perlin noise algorithm with the help of the fast noise lite API.
+     * Throw away the current world and generate it again from the terrain settings around the player.
+     * @param blocking wait until the columns around the player are ready, otherwise the old columns stay
+     * visible and are replaced as soon as the workers finish the new ones
      */
-    void generateTerrain();
+    void generateWorld(bool blocking = false);
 
     /**
-     * Generate trees on top of grass blocks randomly.
+     * Make sure all chunk columns around a position are loaded.
+     * Missing columns are generated on the worker threads and stored once they are finished.
+     * Columns that fall out of range are evicted, modified ones are spilled to disk and restored when coming back.
+     * @param centerX block x coordinate to load around
+     * @param blocking wait until all columns in range are loaded
      */
-    void generateTrees();
+    void loadChunks(float centerX, bool blocking = false);
 
     /**
      * Place a block in the world and updating the surrounding if needed
      * @param pos block position
      * @param type the block type that is intended to be placed
      */
-    void placeBlock(uvec2 pos, BlockType type);
+    void placeBlock(ivec2 pos, BlockType type);
 
     /**
      * Break a block in the world and updating the surrounding if needed.
      * @param pos block position
      */
-    void breakBlock(uvec2 pos);
+    void breakBlock(ivec2 pos);
 
     [[nodiscard]] EntityPlayer* getPlayer() const { return player; };
 
     /**
-     * Updates the game state.
-     * @param deltaTime Time elapsed since the last update, used for time-based calculations.
+     * @return Regions of the world that changed since the last rendered frame, one per changed chunk column and update.
+     */
+    [[nodiscard]] const std::vector<DirtyRegion>& getDirtyRegions() const { return dirtyRegions; }
+
+    [[nodiscard]] const BlockScheduler& getBlockScheduler() const { return blockScheduler; }
+
+    /**
+     * Updates the game state by one simulation step.
+     * @param deltaTime Length of the simulation step in seconds.
      */
     void update(float deltaTime);
 
@@ -104,8 +198,9 @@ public:
     /**
      * Renders the game world.
      * @param camera Reference to the `Camera` object for view transformations.
+     * @param alpha progress between the previous and the latest simulation step, entities are interpolated by it
      */
-    void render(Camera &camera);
+    void render(Camera &camera, float alpha = 1.0f);
 
     /**
      * Redirection for all key inputs for player interaction.
@@ -0,0 +1,82 @@
+#ifndef QUADBATCH_HPP
+#define QUADBATCH_HPP
+#include <vector>
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+namespace arcader {
+/**
+ * Vertex of a batched quad.
+ * Uses the same attribute locations as Mesh::VertexPTN (0 = position, 1 = texCoord) so the game shaders work unchanged,
+ * plus the sprite array layer at location 3.
+ */
+struct QuadVertex {
+    glm::vec3 position;
+    glm::vec2 texCoord;
+    float layer;
+};
+
+/**
+ * Collects many textured quads on the CPU and uploads them into one vertex and index buffer.
+ * Quads can then be drawn all at once or in contiguous ranges (e.g. one range per texture).
+ * The GPU buffers are only reallocated when the batch grows, so rebuilding a batch does not allocate.
+ */
+class QuadBatch {
+public:
+    QuadBatch() = default;
+    ~QuadBatch();
+
+    QuadBatch(const QuadBatch &) = delete;
+    QuadBatch &operator=(const QuadBatch &) = delete;
+
+    /**
+     * Remove all quads from the CPU side. GPU data stays valid until the next upload.
+     */
+    void clear();
+
+    /**
+     * Append an axis aligned quad in the XY plane.
+     * @param position lower left corner
+     * @param size width and height of the quad
+     * @param layer sprite array layer to sample
+     * @param flipX mirror the texture horizontally
+     */
+    void addQuad(const glm::vec3 &position, const glm::vec2 &size, GLint layer, bool flipX = false);
+
+    /**
+     * @return Number of quads currently stored on the CPU side.
+     */
+    [[nodiscard]] GLsizei size() const { return static_cast<GLsizei>(vertices.size() / 4); }
+
+    /**
+     * Upload all quads to the GPU. Must be called before drawing after the batch changed.
+     */
+    void upload();
+
+    /**
+     * Draw a range of uploaded quads with a single draw call.
+     * @param first index of the first quad
+     * @param count number of quads to draw
+     */
+    void draw(GLsizei first, GLsizei count) const;
+
+    /**
+     * Draw all uploaded quads with a single draw call.
+     */
+    void draw() const { draw(0, uploadedQuads); }
+
+private:
+    void initBuffers();
+
+    std::vector<QuadVertex> vertices;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    GLsizei vertexCapacity = 0; // in quads
+    GLsizei indexCapacity = 0;  // in quads
+    GLsizei uploadedQuads = 0;
+};
+} // arcader
+
+#endif //QUADBATCH_HPP
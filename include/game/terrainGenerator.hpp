@@ -0,0 +1,74 @@
+#ifndef TERRAINGENERATOR_HPP
+#define TERRAINGENERATOR_HPP
+#include <cstdint>
+
+#include "FastNoiseLite.hpp"
+#include "block.hpp"
+
+namespace arcader {
+/**
+ * Parameters of the procedural world generation.
+ */
+struct TerrainSettings {
+    int seed = -1;
+    float frequency = 0.03f;
+    float terrainBase = 0.0f;
+    float terrainPeak = 100.0f;
+    float treeFrequency = 0.15f;
+    int waterLevel = 7;
+};
+
+/**
+ * Generates chunk columns of the world from the seed.
+ * Every column only depends on the settings and its position, never on other columns,
+ * so columns can be generated lazily in any order and always fit together at the borders.
+ */
+class TerrainGenerator {
+public:
+    TerrainGenerator(const TerrainSettings &settings, int worldHeight);
+
+    /**
+     * Generate the blocks of one chunk column.
+     * Terrain is based on a perlin noise algorithm with the help of the fast noise lite API,
+     * trees are placed on top of grass blocks randomly.
+     * @param chunkX chunk column coordinate
+     * @param out World::CHUNK_SIZE * worldHeight blocks in world column layout
+     */
+    void generateColumn(int chunkX, BlockType *out) const;
+
+    /**
+     * Hash the blocks of a range of generated chunk columns.
+     * Generation is fully deterministic (no std distributions or libm calls that differ between platforms),
+     * so the same settings give the same hash everywhere. Use it to key cached worlds by their settings
+     * and to check that generator optimizations do not change the output.
+     * @param firstChunkX first chunk column
+     * @param count number of chunk columns
+     */
+    [[nodiscard]] uint64_t hashColumns(int firstChunkX, int count) const;
+
+private:
+    static constexpr int ROW_SIZE = 18; // chunk column plus one neighbour column on each side
+
+    /**
+     * Compute the terrain heights of a row of columns, the noise of the whole row is evaluated in one batch.
+     * @param x0 x coordinate of the first column
+     * @param heights ROW_SIZE results, number of solid terrain blocks in each column
+     */
+    void getTerrainHeights(int x0, int *heights) const;
+
+    /**
+     * Compute the heights of the trees growing on a row of columns.
+     * @param x0 x coordinate of the first column
+     * @param terrainHeights ROW_SIZE terrain heights from getTerrainHeights
+     * @param treeHeights ROW_SIZE results, 0 where there is no tree
+     */
+    void getTreeHeights(int x0, const int *terrainHeights, int *treeHeights) const;
+
+    TerrainSettings settings;
+    int worldHeight;
+    FastNoiseLite noise;
+    FastNoiseLite treeNoise;
+};
+} // arcader
+
+#endif //TERRAINGENERATOR_HPP
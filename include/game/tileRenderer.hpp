@@ -0,0 +1,41 @@
+#ifndef TILERENDERER_HPP
+#define TILERENDERER_HPP
+#include "assetManager.hpp"
+#include "block.hpp"
+#include "quadBatch.hpp"
+#include "world.hpp"
+
+namespace arcader {
+/**
+ * Renders all loaded chunk columns from one cached vertex buffer.
+ * Every block samples its layer of the shared sprite array, so the world is drawn with a single draw call.
+ * The buffer is only rebuilt after the world was marked dirty by a block change.
+ */
+class TileRenderer {
+public:
+    /**
+     * Flag the cached geometry as outdated, it will be rebuilt on the next render.
+     */
+    void markDirty() { dirty = true; }
+
+    [[nodiscard]] bool isDirty() const { return dirty; }
+
+    /**
+     * Regenerate the quad batch from the current block grid and upload it.
+     * @param world Blocks in world
+     * @param assets Asset manager holding the sprite layers
+     */
+    void rebuild(const World &world, const AssetManager &assets);
+
+    /**
+     * Draw all tiles. The tile shader must already be in use with the sprite array bound.
+     */
+    void render() const { batch.draw(); }
+
+private:
+    QuadBatch batch;
+    bool dirty = true;
+};
+} // arcader
+
+#endif //TILERENDERER_HPP
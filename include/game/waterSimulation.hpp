@@ -0,0 +1,35 @@
+#ifndef WATERSIMULATION_HPP
+#define WATERSIMULATION_HPP
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "blockScheduler.hpp"
+#include "world.hpp"
+
+namespace arcader {
+/**
+ * Cellular automaton for flowing water.
+ * Every water cell holds a level from 1 to World::FULL_LEVEL. Water falls into cells below that are not full and
+ * spreads sideways towards neighbours that are at least two levels lower, the total amount of water never changes.
+ * Cells are only updated when the block scheduler wakes them, which only happens when they or a neighbour changed,
+ * so water at rest (e.g. a generated lake) costs nothing. The scheduler runs due cells in a fixed order,
+ * so the flow always gives the same result.
+ */
+class WaterSimulation {
+public:
+    /**
+     * Advance one water cell by one step, changed cells and their neighbours are scheduled again.
+     * Cells outside the loaded world count as solid.
+     */
+    static void update(World &world, glm::ivec2 pos, BlockScheduler &scheduler);
+
+private:
+    /**
+     * Move water from one cell into another, both must be loaded and the target must be air or water.
+     */
+    static void transfer(World &world, glm::ivec2 from, glm::ivec2 to, uint8_t amount, BlockScheduler &scheduler);
+};
+} // arcader
+
+#endif //WATERSIMULATION_HPP
@@ -0,0 +1,201 @@
+#ifndef WORLD_HPP
+#define WORLD_HPP
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "block.hpp"
+
+namespace arcader {
+/**
+ * Rectangle of blocks inside one chunk column that changed, in world block coordinates (bounds inclusive).
+ */
+struct DirtyRegion {
+    int chunkX;
+    int minX, minY;
+    int maxX, maxY;
+};
+
+/**
+ * Block storage of the game world.
+ * The world is unbounded horizontally and has a fixed height. It is split into columns of 16 wide chunks,
+ * only a fixed number of columns is loaded at once. Loaded columns live in a ring of slots inside one
+ * contiguous allocation of 1-byte block ids, so memory stays bounded no matter where the player walks
+ * and every access is a couple of shifts and masks.
+ * Next to the block id every cell stores a fluid level in a second array with the same layout.
+ * Every block change grows a dirty rectangle of its column, consumers drain them once per frame
+ * to update derived data (render buffers, simulation) only where something changed.
+ */
+class World {
+public:
+    static constexpr int CHUNK_SHIFT = 4;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+    static constexpr int NO_CHUNK = INT32_MIN;
+    static constexpr uint8_t FULL_LEVEL = 8; // fluid level of a completely filled water cell
+
+    /**
+     * Create a world without any loaded columns.
+     * @param height height in blocks
+     * @param columnCapacity number of chunk columns that can be loaded at the same time
+     */
+    World(int height, int columnCapacity);
+
+    [[nodiscard]] int getHeight() const { return height; }
+    [[nodiscard]] int getColumnCapacity() const { return static_cast<int>(slotChunks.size()); }
+
+    /**
+     * Number of blocks in one chunk column.
+     */
+    [[nodiscard]] size_t getColumnSize() const { return static_cast<size_t>(CHUNK_SIZE) * height; }
+
+    /**
+     * Convert a block x coordinate to the chunk column containing it (rounds towards negative infinity).
+     */
+    static int toChunk(const int x) { return x >> CHUNK_SHIFT; }
+
+    [[nodiscard]] bool isLoaded(const int chunkX) const { return slotChunks[slotOf(chunkX)] == chunkX; }
+
+    [[nodiscard]] bool isInBounds(const int x, const int y) const {
+        return y >= 0 && y < height && isLoaded(toChunk(x));
+    }
+
+    /**
+     * Get the block at a position without bounds checking, the column must be loaded.
+     */
+    [[nodiscard]] BlockType get(const int x, const int y) const { return blocks[index(x, y)]; }
+
+    /**
+     * Get the block at a position, positions outside the loaded world are air.
+     */
+    [[nodiscard]] BlockType getBlock(const int x, const int y) const {
+        return isInBounds(x, y) ? get(x, y) : BlockType::AIR;
+    }
+
+    /**
+     * Set the block at a position without bounds checking, the column must be loaded.
+     * Water starts as a full cell, every other block has no fluid level.
+     */
+    void set(const int x, const int y, const BlockType type) {
+        const size_t i = index(x, y);
+        if (blocks[i] == type) return;
+        blocks[i] = type;
+        levels[i] = type == BlockType::WATER ? FULL_LEVEL : 0;
+        const int slot = slotOf(toChunk(x));
+        slotModified[slot] = true;
+        markDirty(slot, x & CHUNK_MASK, y, x & CHUNK_MASK, y);
+    }
+
+    /**
+     * Set the block at a position, positions outside the loaded world are ignored.
+     */
+    void setBlock(const int x, const int y, const BlockType type) {
+        if (isInBounds(x, y)) set(x, y, type);
+    }
+
+    /**
+     * Get the fluid level at a position without bounds checking, the column must be loaded.
+     * @return 1 to FULL_LEVEL for water, 0 for every other block
+     */
+    [[nodiscard]] uint8_t getLevel(const int x, const int y) const { return levels[index(x, y)]; }
+
+    /**
+     * Set the fluid level of a water cell without bounds checking, the column must be loaded.
+     */
+    void setLevel(const int x, const int y, const uint8_t level) {
+        const size_t i = index(x, y);
+        if (levels[i] == level) return;
+        levels[i] = level;
+        const int slot = slotOf(toChunk(x));
+        slotModified[slot] = true;
+        markDirty(slot, x & CHUNK_MASK, y, x & CHUNK_MASK, y);
+    }
+
+    /**
+     * Store a column, replacing the column that previously occupied the same slot.
+     * @param chunkX chunk column coordinate
+     * @param data getColumnSize() blocks in column layout (row-major, CHUNK_SIZE blocks per row)
+     * @param revision generation revision the column was created with
+     * @param fluidLevels getColumnSize() fluid levels in column layout, nullptr fills all water cells
+     */
+    void loadColumn(int chunkX, const BlockType *data, uint32_t revision = 0, const uint8_t *fluidLevels = nullptr);
+
+    /**
+     * @return Generation revision a loaded column was created with.
+     */
+    [[nodiscard]] uint32_t getRevision(const int chunkX) const { return slotRevisions[slotOf(chunkX)]; }
+
+    /**
+     * @return The chunk column stored in the slot that chunkX maps to, NO_CHUNK if the slot is empty.
+     */
+    [[nodiscard]] int getSlotOccupant(const int chunkX) const { return slotChunks[slotOf(chunkX)]; }
+
+    /**
+     * @return The chunk column stored in a slot, NO_CHUNK if the slot is empty.
+     */
+    [[nodiscard]] int getLoadedChunk(const int slot) const { return slotChunks[slot]; }
+
+    /**
+     * @return Blocks of a loaded column in column layout.
+     */
+    [[nodiscard]] const BlockType *getColumn(const int chunkX) const {
+        return &blocks[static_cast<size_t>(slotOf(chunkX)) * getColumnSize()];
+    }
+
+    /**
+     * @return Fluid levels of a loaded column in column layout.
+     */
+    [[nodiscard]] const uint8_t *getColumnLevels(const int chunkX) const {
+        return &levels[static_cast<size_t>(slotOf(chunkX)) * getColumnSize()];
+    }
+
+    /**
+     * Check if a loaded column was changed since it was loaded, i.e. it can not be regenerated from the seed.
+     */
+    [[nodiscard]] bool isModified(const int chunkX) const { return slotModified[slotOf(chunkX)]; }
+
+    /**
+     * Unload all columns.
+     */
+    void clear();
+
+    /**
+     * Append the dirty rectangles of all loaded columns and reset them.
+     * A freshly loaded column is dirty as a whole.
+     * @param out receives one region per changed column, not cleared before
+     */
+    void drainDirty(std::vector<DirtyRegion> &out);
+
+private:
+    /**
+     * Grow the dirty rectangle of a slot, coordinates are local to the column.
+     */
+    void markDirty(const int slot, const int minX, const int minY, const int maxX, const int maxY) {
+        DirtyRegion &region = slotDirty[slot];
+        region.minX = std::min(region.minX, minX);
+        region.minY = std::min(region.minY, minY);
+        region.maxX = std::max(region.maxX, maxX);
+        region.maxY = std::max(region.maxY, maxY);
+    }
+
+    [[nodiscard]] int slotOf(const int chunkX) const {
+        const int capacity = getColumnCapacity();
+        return (chunkX % capacity + capacity) % capacity;
+    }
+
+    [[nodiscard]] size_t index(const int x, const int y) const {
+        return static_cast<size_t>(slotOf(toChunk(x))) * getColumnSize() +
+               (static_cast<size_t>(y) << CHUNK_SHIFT) + (x & CHUNK_MASK);
+    }
+
+    int height;
+    std::vector<BlockType> blocks;
+    std::vector<uint8_t> levels;
+    std::vector<int> slotChunks;
+    std::vector<bool> slotModified;
+    std::vector<uint32_t> slotRevisions;
+    std::vector<DirtyRegion> slotDirty; // local coordinates, empty while min > max
+};
+} // arcader
+
+#endif //WORLD_HPP
@@ -7,15 +7,19 @@
 #define ARCADE_LIGHTINGSYSTEM_HPP
 
 #include <glm/glm.hpp>
-#include <framework/gl/program.hpp>
 #include <vector>
 
+#include "uniformBuffer.hpp"
+
 namespace arcader {
 
     class LightingSystem {
     public:
         glm::vec3 lightColor = glm::vec3(1.0f);
 
+        static constexpr int MAX_POINT_LIGHTS = 8; // same as in arcade.fsh
+        static constexpr int SHADOW_CASCADES = 3;  // same as in arcade.fsh, at most 4
+
         struct PointLight {
             glm::vec3 position;
             glm::vec3 color;
@@ -23,18 +27,57 @@ namespace arcader {
             float radius;
         };
 
+        /**
+         * @brief World to clip space of every shadow map cascade and the view depth each cascade reaches to.
+         */
+        struct ShadowCascades {
+            glm::mat4 lightSpaceMatrices[SHADOW_CASCADES];
+            glm::vec4 splits; // component i belongs to cascade i
+        };
+
         void init(const glm::vec3& ambientColor, const glm::vec3& lightDir, const glm::vec3& lightColor);
         void update(const glm::vec3& newDir, const glm::vec3& newColor);
-        void bindToShader(Program& shader) const;
         glm::vec3 getDirection() const;
 
+        /**
+         * Upload the lights to the Lighting uniform block, shared by every shader declaring it.
+         * Call once per frame before drawing lit geometry.
+         * @param cascades the shadow map cascades fitted to the current view
+         */
+        void upload(const ShadowCascades& cascades);
+
         void addPointLight(const glm::vec3& position, const glm::vec3& color, float intensity, float radius);
         const std::vector<PointLight>& getPointLights() const;
-        void bindPointLightsToShader(Program& shader) const;
         void clearPointLights();
         void setPointLightIntensity(int index, float intensity);
 
     private:
+        // std140 layout of the Lighting block in arcade.fsh
+        struct Block {
+            struct Light {
+                glm::vec3 position;
+                float padding0;
+                glm::vec3 color;
+                float intensity;
+                float radius;
+                float padding1[3];
+            };
+
+            glm::mat4 lightSpaceMatrices[SHADOW_CASCADES];
+            glm::vec4 cascadeSplits;
+            glm::vec3 ambientColor;
+            float padding0;
+            glm::vec3 lightDirection;
+            float padding1;
+            glm::vec3 lightColor;
+            int numPointLights;
+            Light pointLights[MAX_POINT_LIGHTS];
+        };
+        static_assert(sizeof(Block::Light) == 48);
+        static_assert(sizeof(Block) == 64 * SHADOW_CASCADES + 64 + 48 * MAX_POINT_LIGHTS);
+        static_assert(SHADOW_CASCADES <= 4, "the cascade splits are packed into one vec4");
+
+        UniformBuffer<Block> buffer{UniformBlock::LIGHTING};
         glm::vec3 ambientColor = glm::vec3(0.2f);
         glm::vec3 lightDirection = glm::vec3(-0.5f, -1.0f, -0.3f);
         std::vector<PointLight> pointLights;
@@ -0,0 +1,91 @@
+#ifndef ARCADE_LOCKFREEQUEUE_HPP
+#define ARCADE_LOCKFREEQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace arcader {
+
+    /**
+     * @brief Bounded multi-producer multi-consumer queue without locks.
+     *
+     * Every cell carries a sequence number telling producers and consumers whose turn it is,
+     * so push and pop only need a single compare-and-swap and never allocate.
+     * @tparam Capacity number of cells, must be a power of two
+     */
+    template<typename T, size_t Capacity>
+    class LockFreeQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        LockFreeQueue() {
+            for (size_t i = 0; i < Capacity; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        LockFreeQueue(const LockFreeQueue &) = delete;
+        LockFreeQueue &operator=(const LockFreeQueue &) = delete;
+
+        /**
+         * @return false if the queue is full, the value is left untouched in that case
+         */
+        bool push(T &&value) {
+            Cell *cell;
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            while (true) {
+                cell = &cells[pos & (Capacity - 1)];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->data = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @return false if the queue is empty
+         */
+        bool pop(T &out) {
+            Cell *cell;
+            size_t pos = dequeuePos.load(std::memory_order_relaxed);
+            while (true) {
+                cell = &cells[pos & (Capacity - 1)];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+            out = std::move(cell->data);
+            cell->sequence.store(pos + Capacity, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        std::array<Cell, Capacity> cells;
+        alignas(64) std::atomic<size_t> enqueuePos{0};
+        alignas(64) std::atomic<size_t> dequeuePos{0};
+    };
+
+} // arcader
+
+#endif //ARCADE_LOCKFREEQUEUE_HPP
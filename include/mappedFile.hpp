@@ -0,0 +1,45 @@
+#ifndef ARCADE_MAPPEDFILE_HPP
+#define ARCADE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+
+namespace arcader {
+
+    /**
+     * @brief Read-only memory mapping of a whole file.
+     *
+     * Pages are loaded by the OS on first access, so opening is cheap and nothing is copied before the data is
+     * actually used, e.g. by a buffer upload.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /**
+         * Map a file, replacing the current mapping.
+         * @return false if the file does not exist, is empty or cannot be mapped
+         */
+        bool open(const std::filesystem::path &path);
+
+        void close();
+
+        [[nodiscard]] const std::byte *data() const { return bytes; }
+        [[nodiscard]] size_t size() const { return length; }
+        [[nodiscard]] bool isOpen() const { return bytes != nullptr; }
+
+    private:
+        const std::byte *bytes = nullptr;
+        size_t length = 0;
+    };
+
+} // arcader
+
+#endif //ARCADE_MAPPEDFILE_HPP
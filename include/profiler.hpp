@@ -0,0 +1,157 @@
+#ifndef ARCADE_PROFILER_HPP
+#define ARCADE_PROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include "traceWriter.hpp"
+
+namespace arcader {
+
+    /**
+     * @brief One timed scope of a frame, times are in milliseconds since the start of the frame.
+     */
+    struct ProfileSample {
+        const char *name;
+        int depth;
+        double cpuBegin;
+        double cpuEnd;
+        double gpuBegin = -1.0; // negative if the scope was not measured on the GPU
+        double gpuEnd = -1.0;
+        GLsizei queryBegin = -1; // timestamp queries of the frame, -1 for CPU only scopes
+        GLsizei queryEnd = -1;
+    };
+
+    /**
+     * @brief Frame profiler with nested CPU scopes and GPU timestamp queries.
+     *
+     * Scopes are recorded with ProfileScope on the render thread only. GPU queries of a frame are read back
+     * FRAME_LATENCY - 1 frames later and only if they are already available, so profiling never stalls the pipeline.
+     * Resolved frames feed a rolling per-scope history shown by buildImGui and can be captured to a trace file.
+     */
+    class Profiler {
+    public:
+        static constexpr int FRAME_LATENCY = 3; // frames in flight, each with its own query pool
+        static constexpr int HISTORY_SIZE = 240;
+
+        /**
+         * @return The profiler of the render thread.
+         */
+        static Profiler &get();
+
+        /**
+         * Close the running frame and start a new one. Call once at the start of every frame.
+         * @param state cinematic state of the new frame, tagged in trace captures
+         */
+        void beginFrame(int state = 0);
+
+        /**
+         * Open a scope, use ProfileScope instead of calling this directly.
+         * @param name static string naming the scope
+         * @param gpu also measure the GL commands issued inside the scope
+         * @return Handle for end
+         */
+        size_t begin(const char *name, bool gpu);
+
+        /**
+         * Close a scope opened by begin.
+         */
+        void end(size_t handle);
+
+        /**
+         * Draw the frame time graphs, a flame view of the latest resolved frame and the per-scope averages.
+         */
+        void buildImGui() const;
+
+        /**
+         * Capture the next frames to a Chrome Trace Event JSON file, see TraceWriter.
+         * @param path output file
+         * @param seconds length of the capture
+         */
+        void startTrace(const std::filesystem::path &path, const double seconds) { trace.start(path, seconds); }
+
+        [[nodiscard]] bool isTracing() const { return trace.isCapturing(); }
+
+        /**
+         * @return The latest frame whose GPU results were read back.
+         */
+        [[nodiscard]] const std::vector<ProfileSample> &getLatestFrame() const { return latest.samples; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Frame {
+            std::vector<ProfileSample> samples;
+            std::vector<GLuint> queries;
+            GLsizei usedQueries = 0;
+            Clock::time_point start;
+            double cpuMs = 0.0;
+            double gpuMs = -1.0;
+            int state = 0;
+            bool pending = false; // finished but not resolved yet
+        };
+
+        struct ScopeHistory {
+            std::array<float, HISTORY_SIZE> cpu{};
+            std::array<float, HISTORY_SIZE> gpu{};
+        };
+
+        // Lets scopes be found by the name of a sample without constructing a std::string
+        struct NameHash {
+            using is_transparent = void;
+            size_t operator()(const std::string_view name) const { return std::hash<std::string_view>{}(name); }
+        };
+
+        Profiler() = default;
+
+        /**
+         * Issue a GPU timestamp query into the current frame's pool.
+         * @return Index of the query in the pool
+         */
+        GLsizei timestamp();
+
+        /**
+         * Read back the queries of a finished frame and add it to the history.
+         */
+        void resolve(Frame &frame);
+
+        std::array<Frame, FRAME_LATENCY> frames;
+        int current = 0;
+        int depth = 0;
+        bool started = false;
+
+        Frame latest;
+        int historyIndex = 0;
+        std::array<float, HISTORY_SIZE> frameCpu{};
+        std::array<float, HISTORY_SIZE> frameGpu{};
+        std::unordered_map<std::string, ScopeHistory, NameHash, std::equal_to<>> scopes;
+        TraceWriter trace;
+    };
+
+    /**
+     * @brief RAII marker timing the enclosing block, e.g. `const ProfileScope scope("Shadow Pass", true);`
+     */
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const char *name, const bool gpu = false) : handle(Profiler::get().begin(name, gpu)) {}
+
+        ~ProfileScope() { Profiler::get().end(handle); }
+
+        ProfileScope(const ProfileScope &) = delete;
+        ProfileScope &operator=(const ProfileScope &) = delete;
+
+    private:
+        size_t handle;
+    };
+
+} // arcader
+
+#endif //ARCADE_PROFILER_HPP
@@ -0,0 +1,92 @@
+#ifndef ARCADE_PROGRAMCACHE_HPP
+#define ARCADE_PROGRAMCACHE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <framework/gl/program.hpp>
+
+namespace arcader {
+
+    /**
+     * @brief Loads shader programs from linked binaries in the CookCache instead of compiling them.
+     *
+     * The cache key covers both shader sources and the GL vendor, renderer and version strings, so edited shaders
+     * and driver updates fall back to compiling. A binary the driver rejects is compiled and stored again.
+     * Drivers without program binary formats always compile. Render thread only.
+     *
+     * Every loaded program is also watched: reloadChanged recompiles programs whose shader files were modified,
+     * so shaders can be tuned while the game runs. The watch keeps the address of the Program, so a loaded Program
+     * must not be moved or copied afterwards and has to outlive the reloads.
+     */
+    class ProgramCache {
+    public:
+        static constexpr uint32_t VERSION = 1;
+        static constexpr std::chrono::milliseconds POLL_INTERVAL{250};
+
+        /**
+         * @return The program cache of the render thread.
+         */
+        static ProgramCache &get();
+
+        /**
+         * Load a program from its cached binary, or compile it with Program::load and cache the binary.
+         */
+        void load(Program &program, const std::filesystem::path &vertexPath, const std::filesystem::path &fragmentPath);
+
+        /**
+         * Print the load time of every program loaded so far and whether it was compiled or read from the cache.
+         */
+        void printReport() const;
+
+        /**
+         * Recompile the programs whose shader files changed since they were loaded, checks the files at most
+         * every POLL_INTERVAL. A reloaded program keeps its Program object and uniform values, only the handle
+         * changes. A program that fails to compile or link keeps running with its previous version.
+         */
+        void reloadChanged();
+
+    private:
+        struct LoadTime {
+            std::string name;
+            double milliseconds;
+            bool cached;
+        };
+
+        struct Watch {
+            Program *program;
+            GLuint handle; // handle the program had when it was loaded or last reloaded
+            std::filesystem::path vertexPath;
+            std::filesystem::path fragmentPath;
+            std::filesystem::file_time_type vertexTime;
+            std::filesystem::file_time_type fragmentTime;
+        };
+
+        ProgramCache() = default;
+
+        std::optional<uint64_t> cacheKey(const std::filesystem::path &vertexPath,
+                                         const std::filesystem::path &fragmentPath);
+
+        bool loadBinary(Program &program, uint64_t key) const;
+
+        void storeBinary(const Program &program, uint64_t key) const;
+
+        void watch(Program &program, const std::filesystem::path &vertexPath,
+                   const std::filesystem::path &fragmentPath);
+
+        bool reload(const Watch &watch);
+
+        std::optional<bool> supported; // driver offers program binary formats, queried on first use
+        uint64_t driver = 0;           // hash of the vendor, renderer and version strings
+        std::vector<LoadTime> loadTimes;
+        std::vector<Watch> watches;
+        std::chrono::steady_clock::time_point nextPoll;
+    };
+
+} // arcader
+
+#endif //ARCADE_PROGRAMCACHE_HPP
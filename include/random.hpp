@@ -0,0 +1,84 @@
+#ifndef ARCADE_RANDOM_HPP
+#define ARCADE_RANDOM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace arcader {
+
+    /**
+     * @brief Small portable pseudo random generator (SplitMix64).
+     *
+     * Unlike the standard engines combined with std::uniform_*_distribution or std::shuffle,
+     * every operation here is fully specified, so a seed gives the same sequence with every
+     * compiler, standard library and platform. Use it for everything that has to be reproducible from a seed.
+     */
+    class Random {
+    public:
+        explicit Random(const uint64_t seed) : state(seed) {}
+
+        /**
+         * Mix any number of values into a well distributed 64 bit hash, e.g. a seed and a coordinate.
+         */
+        template<typename... Values>
+        static uint64_t hash(const uint64_t first, const Values... values) {
+            uint64_t h = mix(first);
+            ((h = mix(h ^ static_cast<uint64_t>(values))), ...);
+            return h;
+        }
+
+        uint64_t next() {
+            state += 0x9e3779b97f4a7c15ull;
+            return mix(state);
+        }
+
+        uint32_t nextU32() {
+            return static_cast<uint32_t>(next() >> 32);
+        }
+
+        /**
+         * @return uniform value in [0, bound), bound must not be 0
+         */
+        uint32_t nextInt(const uint32_t bound) {
+            return static_cast<uint32_t>((static_cast<uint64_t>(nextU32()) * bound) >> 32);
+        }
+
+        /**
+         * @return uniform value in [0, 1), exactly representable so no rounding is involved
+         */
+        float nextFloat() {
+            return static_cast<float>(next() >> 40) * 0x1.0p-24f;
+        }
+
+        /**
+         * @return uniform value in [min, max)
+         */
+        float nextFloat(const float min, const float max) {
+            return min + nextFloat() * (max - min);
+        }
+
+        /**
+         * Fisher-Yates shuffle with a fixed algorithm, std::shuffle differs between standard libraries.
+         */
+        template<typename Container>
+        void shuffle(Container &container) {
+            for (size_t i = container.size(); i > 1; --i) {
+                const size_t j = nextInt(static_cast<uint32_t>(i));
+                std::swap(container[i - 1], container[j]);
+            }
+        }
+
+    private:
+        static uint64_t mix(uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        uint64_t state;
+    };
+
+}
+
+#endif // ARCADE_RANDOM_HPP
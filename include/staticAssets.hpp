@@ -0,0 +1,44 @@
+#ifndef ARCADE_STATICASSETS_HPP
+#define ARCADE_STATICASSETS_HPP
+
+namespace arcader {
+
+    /**
+     * @brief Names of the assets held by the AssetManager. Kept apart from it, so the game simulation can refer to
+     * sprites without depending on GL.
+     */
+    enum class StaticAssets {
+        MISSING_TEXTURE,
+
+        BLOCK_GRASS,
+        BLOCK_DIRT,
+        BLOCK_WOOD,
+        BLOCK_LEAVES,
+        BLOCK_STONE,
+        BLOCK_WATER,
+        BLOCK_AIR,
+        PLAYER_IDLE,
+        PLAYER_WALK1,
+        PLAYER_WALK2,
+        PLAYER_WALK3,
+        PLAYER_MINE,
+        HUD_SLOT,
+        BACKGROUND,
+
+        SHADER_TILE,
+        SHADER_ENTITY,
+        SHADER_DEBUG,
+        SHADER_HUD,
+
+        ARCADE_MACHINES, // instanced group of all arcade machine variants
+        ARCADE_MACHINE,
+        ARCADE_MACHINE_2,
+        ARCADE_MACHINE_3,
+        ARCADE_MACHINE_4,
+        ARCADE_MACHINE_5,
+        ROOM
+    };
+
+} // arcader
+
+#endif //ARCADE_STATICASSETS_HPP
@@ -0,0 +1,141 @@
+#ifndef ARCADE_STATICMESH_HPP
+#define ARCADE_STATICMESH_HPP
+
+#include <filesystem>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+namespace arcader {
+
+    /**
+     * @brief Vertex of a static mesh, same attribute locations as Mesh::VertexPTN
+     * (0 = position, 1 = texCoord, 2 = normal).
+     */
+    struct MeshVertex {
+        glm::vec3 position;
+        glm::vec2 texCoord;
+        glm::vec3 normal;
+    };
+
+    /**
+     * @brief Axis aligned bounding box in model space.
+     */
+    struct MeshBounds {
+        glm::vec3 min{0.0f};
+        glm::vec3 max{0.0f};
+    };
+
+    /**
+     * @brief Mesh data on the CPU, e.g. parsed on a worker thread before the upload.
+     */
+    struct MeshData {
+        std::vector<MeshVertex> vertices;
+        std::vector<GLuint> indices;
+
+        [[nodiscard]] MeshBounds computeBounds() const;
+    };
+
+    /**
+     * @brief Per-instance data of an instanced draw, attribute locations 3-6 (model matrix) and 7 (layer).
+     */
+    struct MeshInstance {
+        glm::mat4 model;
+        float layer; // texture array layer of the instance
+    };
+
+    /**
+     * @brief Instances in their own GL buffer, uploaded once and drawn any number of times with
+     * StaticMesh::drawInstanced.
+     */
+    class InstanceBuffer {
+    public:
+        InstanceBuffer() = default;
+        ~InstanceBuffer();
+
+        InstanceBuffer(InstanceBuffer &&other) noexcept;
+        InstanceBuffer &operator=(InstanceBuffer &&other) noexcept;
+
+        InstanceBuffer(const InstanceBuffer &) = delete;
+        InstanceBuffer &operator=(const InstanceBuffer &) = delete;
+
+        /**
+         * Replace the instances, only when they change: draws of the previous frames may still read the buffer.
+         */
+        void upload(const std::vector<MeshInstance> &instances);
+
+        [[nodiscard]] GLsizei size() const { return count; }
+
+        GLuint handle = 0;
+
+    private:
+        GLsizei count = 0;
+    };
+
+    class CookedMesh;
+
+    /**
+     * @brief Indexed triangle mesh in its own vertex array, drawable once or many times with one instanced draw.
+     *
+     * Unlike the framework Mesh it exposes its vertex array, so per-instance attributes can be attached.
+     * Instanced draws point those attributes at an InstanceBuffer, the instances are not uploaded per draw.
+     */
+    class StaticMesh {
+    public:
+        StaticMesh() = default;
+        ~StaticMesh();
+
+        StaticMesh(StaticMesh &&other) noexcept;
+        StaticMesh &operator=(StaticMesh &&other) noexcept;
+
+        StaticMesh(const StaticMesh &) = delete;
+        StaticMesh &operator=(const StaticMesh &) = delete;
+
+        /**
+         * Parse a Wavefront OBJ file, polygons are triangulated as fans.
+         * @return false if the file could not be read
+         */
+        static bool parseObj(const std::filesystem::path &path, MeshData &data);
+
+        /**
+         * Load and upload an OBJ file through its cooked version, an unreadable file leaves the mesh empty.
+         */
+        void load(const std::filesystem::path &path);
+
+        void upload(const MeshData &data);
+
+        /**
+         * Upload straight from the cooked (usually memory mapped) data, keeping its index size.
+         */
+        void upload(const CookedMesh &cooked);
+
+        void draw() const;
+
+        /**
+         * Draw the mesh once per instance with a single draw call.
+         */
+        void drawInstanced(const InstanceBuffer &instances);
+
+        [[nodiscard]] GLsizei getIndexCount() const { return indexCount; }
+
+        [[nodiscard]] const MeshBounds &getBounds() const { return bounds; }
+
+    private:
+        void release();
+
+        void upload(const void *vertices, size_t vertexCount, const void *indices, size_t indexSize,
+                    GLsizei count, GLenum type);
+
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        GLsizei indexCount = 0;
+        bool instanceAttributes = false; // attributes 3-7 are enabled after the first instanced draw
+        GLenum indexType = GL_UNSIGNED_INT;
+        MeshBounds bounds;
+    };
+
+} // arcader
+
+#endif //ARCADE_STATICMESH_HPP
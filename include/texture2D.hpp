@@ -0,0 +1,78 @@
+#ifndef ARCADE_TEXTURE2D_HPP
+#define ARCADE_TEXTURE2D_HPP
+
+#include <filesystem>
+#include <vector>
+
+#include <glad/gl.h>
+
+namespace arcader {
+
+    /**
+     * @brief Image decoded to RGBA8 on the CPU, bottom row first as GL expects it.
+     */
+    struct DecodedImage {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;
+
+        /**
+         * Decode an image file, safe to call from worker threads.
+         * A missing or broken file gives a 1x1 magenta image and an error message.
+         */
+        static DecodedImage load(const std::filesystem::path &path);
+    };
+
+    class CookedTexture;
+
+    /**
+     * @brief GL_TEXTURE_2D owned by the asset manager, uploaded from a DecodedImage on the render thread.
+     */
+    class Texture2D {
+    public:
+        Texture2D() = default;
+        ~Texture2D();
+
+        Texture2D(Texture2D &&other) noexcept;
+        Texture2D &operator=(Texture2D &&other) noexcept;
+
+        Texture2D(const Texture2D &) = delete;
+        Texture2D &operator=(const Texture2D &) = delete;
+
+        static constexpr GLint FULL_MIP_CHAIN = -1; // mipmaps value for every level down to 1x1
+
+        /**
+         * Upload the image with linear filtering and repeat wrapping.
+         * @param internalFormat storage format, e.g. GL_SRGB8_ALPHA8 for color textures
+         * @param mipmaps number of mip levels to generate below the base level, 0 for none, FULL_MIP_CHAIN for all
+         */
+        void upload(const DecodedImage &image, GLenum internalFormat = GL_SRGB8_ALPHA8, GLint mipmaps = 0);
+
+        /**
+         * Upload the compressed blocks and the precomputed mip chain of a cooked texture. Without S3TC support
+         * the blocks are decoded on the CPU and uploaded uncompressed.
+         * @param srgb whether the texels are sRGB encoded colors
+         * @param mipmaps number of mip levels to upload below the base level, 0 for none, FULL_MIP_CHAIN for all
+         */
+        void upload(const CookedTexture &texture, bool srgb = true, GLint mipmaps = 0);
+
+        /**
+         * @return true if the driver can sample S3TC (BC1 - BC3) textures and softwareDecode is off
+         */
+        static bool supportsCompression();
+
+        static inline bool softwareDecode = false; // decode cooked textures on the CPU, for testing the fallback
+
+        /**
+         * Bind to a texture unit, the active unit is GL_TEXTURE0 again afterwards.
+         */
+        void bindTextureUnit(GLuint unit) const;
+
+        GLuint handle = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+} // arcader
+
+#endif //ARCADE_TEXTURE2D_HPP
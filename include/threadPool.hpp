@@ -0,0 +1,49 @@
+#ifndef ARCADE_THREADPOOL_HPP
+#define ARCADE_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace arcader {
+
+    /**
+     * @brief Small fixed-size pool of worker threads for background jobs.
+     *
+     * Jobs are taken from a shared FIFO queue. Results should be handed back to the main thread
+     * through a LockFreeQueue, jobs must never touch GL or game state directly.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @param threadCount number of workers, defaults to all cores except the one running the render thread
+         */
+        explicit ThreadPool(unsigned threadCount = defaultThreadCount());
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        void submit(std::function<void()> job);
+
+        unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+        static unsigned defaultThreadCount();
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+    };
+
+} // arcader
+
+#endif //ARCADE_THREADPOOL_HPP
@@ -0,0 +1,77 @@
+#ifndef ARCADE_TRACEWRITER_HPP
+#define ARCADE_TRACEWRITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace arcader {
+
+    struct ProfileSample;
+
+    /**
+     * @brief Captures profiler frames into a Chrome Trace Event JSON file (chrome://tracing, ui.perfetto.dev).
+     *
+     * Frames are buffered in memory while capturing. The file is written on a background thread once the capture
+     * ends, so tracing does not cause hitches itself. CPU scopes go to thread 1, GPU scopes to thread 2, the GPU
+     * times of a frame are aligned to the start of the frame on the CPU.
+     */
+    class TraceWriter {
+    public:
+        TraceWriter() = default;
+        ~TraceWriter();
+
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter &operator=(const TraceWriter &) = delete;
+
+        /**
+         * Start capturing, frames that started before this call are ignored. Skipped while a capture is running or
+         * the previous one is still being written, so the render thread never waits for the writer.
+         * @param path output file, written when the capture ends
+         * @param seconds length of the capture
+         */
+        void start(std::filesystem::path path, double seconds);
+
+        [[nodiscard]] bool isCapturing() const { return capturing; }
+
+        /**
+         * Add a resolved frame to the capture, ends the capture once its length is reached.
+         * @param start CPU time the frame started at
+         * @param cpuMs CPU duration of the frame
+         * @param gpuMs GPU duration of the frame, negative if unknown
+         * @param state cinematic state the frame was rendered in
+         * @param samples scopes of the frame
+         */
+        void addFrame(std::chrono::steady_clock::time_point start, double cpuMs, double gpuMs, int state,
+                      const std::vector<ProfileSample> &samples);
+
+    private:
+        struct Event {
+            const char *name;
+            double timestamp; // microseconds since the start of the capture
+            double duration;  // microseconds
+            int thread;
+            int state;
+        };
+
+        /**
+         * Hand the buffered events to the writer thread.
+         */
+        void finish();
+
+        static void write(const std::filesystem::path &path, const std::vector<Event> &events);
+
+        std::vector<Event> events;
+        std::filesystem::path path;
+        std::chrono::steady_clock::time_point origin;
+        double seconds = 0.0;
+        bool capturing = false;
+        std::atomic<bool> writing = false; // the writer thread has not finished the file yet
+        std::thread writer;
+    };
+
+} // arcader
+
+#endif //ARCADE_TRACEWRITER_HPP
@@ -0,0 +1,77 @@
+#ifndef ARCADE_UNIFORMBUFFER_HPP
+#define ARCADE_UNIFORMBUFFER_HPP
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+namespace arcader {
+
+    /**
+     * @brief Binding points of the uniform blocks shared by all shaders.
+     *
+     * Every program gets its blocks bound to these points by UniformCache, so a buffer bound once per frame
+     * is seen by every shader declaring the block.
+     */
+    enum class UniformBlock : GLuint {
+        CAMERA = 0,   // `layout(std140) uniform Camera`, see CameraBlock
+        LIGHTING = 1, // `layout(std140) uniform Lighting`, see LightingSystem::Block
+        RETRO = 2     // `layout(std140) uniform Retro`, see RetroBlock
+    };
+
+    /**
+     * @brief std140 layout of the Camera block.
+     */
+    struct CameraBlock {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 position; // w unused
+    };
+    static_assert(sizeof(CameraBlock) == 144);
+
+    /**
+     * @brief GL uniform buffer holding one std140 block, uploaded as a whole and bound to its binding point.
+     * @tparam T plain struct matching the std140 layout of the block in the shaders
+     */
+    template<typename T>
+    class UniformBuffer {
+    public:
+        explicit UniformBuffer(const UniformBlock binding) : binding(binding) {}
+
+        ~UniformBuffer() {
+            if (buffer) glDeleteBuffers(1, &buffer);
+        }
+
+        UniformBuffer(const UniformBuffer &) = delete;
+        UniformBuffer &operator=(const UniformBuffer &) = delete;
+
+        /**
+         * Replace the contents of the buffer and bind it, the buffer is created on the first upload.
+         */
+        void upload(const T &data) {
+            if (!buffer) {
+                glGenBuffers(1, &buffer);
+                glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+                glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+            } else {
+                glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+            }
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &data);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            bind();
+        }
+
+        /**
+         * Bind the buffer to its binding point again, e.g. after another buffer was bound there.
+         */
+        void bind() const {
+            glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(binding), buffer);
+        }
+
+    private:
+        UniformBlock binding;
+        GLuint buffer = 0;
+    };
+
+} // arcader
+
+#endif //ARCADE_UNIFORMBUFFER_HPP
@@ -0,0 +1,61 @@
+#ifndef ARCADE_UNIFORMCACHE_HPP
+#define ARCADE_UNIFORMCACHE_HPP
+
+#include <utility>
+#include <vector>
+
+#include <framework/gl/program.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace arcader {
+
+    /**
+     * @brief Uniform locations of one program, resolved on first use instead of on every set.
+     *
+     * Names are expected to be string literals: they are compared by pointer first, so setting the same uniform
+     * again never builds a string or calls glGetUniformLocation. The uniform blocks of UniformBlock are bound to
+     * their binding points when the cache is created. Like Program::set, the program has to be in use.
+     * If the program gets a new handle (a hot reload), the locations are resolved again.
+     */
+    class UniformCache {
+    public:
+        UniformCache() = default;
+
+        explicit UniformCache(const Program &program);
+
+        /**
+         * Bind the uniform blocks a program declares to their UniformBlock binding points.
+         * Done by the constructor, only needed for programs that set no uniforms besides their blocks.
+         */
+        static void bindBlocks(const Program &program);
+
+        /**
+         * @return Location of the uniform, -1 if the program does not have it (setting it is a no-op then)
+         */
+        GLint location(const char *name);
+
+        void set(const char *name, const int value) { glUniform1i(location(name), value); }
+        void set(const char *name, const bool value) { glUniform1i(location(name), value ? 1 : 0); }
+        void set(const char *name, const float value) { glUniform1f(location(name), value); }
+        void set(const char *name, const glm::vec2 &value) { glUniform2fv(location(name), 1, glm::value_ptr(value)); }
+        void set(const char *name, const glm::vec3 &value) { glUniform3fv(location(name), 1, glm::value_ptr(value)); }
+        void set(const char *name, const glm::vec4 &value) { glUniform4fv(location(name), 1, glm::value_ptr(value)); }
+
+        void set(const char *name, const glm::mat3 &value) {
+            glUniformMatrix3fv(location(name), 1, GL_FALSE, glm::value_ptr(value));
+        }
+
+        void set(const char *name, const glm::mat4 &value) {
+            glUniformMatrix4fv(location(name), 1, GL_FALSE, glm::value_ptr(value));
+        }
+
+    private:
+        const Program *program = nullptr;
+        GLuint handle = 0; // handle the locations belong to
+        std::vector<std::pair<const char *, GLint>> locations;
+    };
+
+} // arcader
+
+#endif //ARCADE_UNIFORMCACHE_HPP
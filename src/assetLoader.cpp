@@ -0,0 +1,31 @@
+#include "assetLoader.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace arcader {
+
+    bool AssetLoader::update(const double budgetMs) {
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::duration<double, std::milli>(budgetMs);
+        do {
+            if (steps.empty() || !steps.front().ready()) break;
+            const Step step = std::move(steps.front());
+            steps.pop_front();
+            step.finish();
+            ++finished;
+        } while (Clock::now() < deadline);
+        return steps.empty();
+    }
+
+    void AssetLoader::finishAll() {
+        while (!steps.empty()) {
+            if (!steps.front().ready()) {
+                std::this_thread::yield();
+                continue;
+            }
+            update(0.0);
+        }
+    }
+
+} // arcader
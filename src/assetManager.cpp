@@ -4,10 +4,13 @@
 
 #include "assetManager.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <framework/objparser.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "programCache.hpp"
+
 namespace arcader {
 
     AssetManager::AssetManager() {
@@ -24,42 +27,175 @@ namespace arcader {
     void
     AssetManager::loadTexture(const StaticAssets &name, const std::filesystem::path &filepath, GLenum internalFormat,
                               GLint mipmaps) {
-        Texture<GL_TEXTURE_2D> tex;
-        tex.load(internalFormat, filepath, mipmaps);
-        textures[name] = std::move(tex);
+        textures[name].upload(DecodedImage::load(filepath), internalFormat, mipmaps);
+    }
+
+    void AssetManager::loadTextureAsync(const StaticAssets &name, const std::filesystem::path &filepath,
+                                        GLenum internalFormat, GLint mipmaps) {
+        loader.enqueue<DecodedImage>(
+            [filepath] { return DecodedImage::load(filepath); },
+            [this, name, internalFormat, mipmaps](DecodedImage &image) {
+                textures[name].upload(image, internalFormat, mipmaps);
+            });
+    }
+
+    AssetManager::TextureSource AssetManager::readTexture(const std::filesystem::path &filepath,
+                                                          const GLenum internalFormat) {
+        TextureSource source;
+        const bool compressible = internalFormat == GL_SRGB8_ALPHA8 || internalFormat == GL_RGBA8;
+        if (!compressible || !source.cooked.load(filepath)) source.image = DecodedImage::load(filepath);
+        return source;
+    }
+
+    void AssetManager::uploadTexture(const StaticAssets &name, const TextureSource &source, const GLenum internalFormat,
+                                     const GLint mipmaps) {
+        if (source.cooked.isLoaded()) textures[name].upload(source.cooked, internalFormat == GL_SRGB8_ALPHA8, mipmaps);
+        else textures[name].upload(source.image, internalFormat, mipmaps);
+    }
+
+    void AssetManager::loadCompressedTexture(const StaticAssets &name, const std::filesystem::path &filepath,
+                                             const GLenum internalFormat, const GLint mipmaps) {
+        uploadTexture(name, readTexture(filepath, internalFormat), internalFormat, mipmaps);
+    }
+
+    void AssetManager::loadCompressedTextureAsync(const StaticAssets &name, const std::filesystem::path &filepath,
+                                                  GLenum internalFormat, GLint mipmaps) {
+        loader.enqueue<TextureSource>(
+            [filepath, internalFormat] { return readTexture(filepath, internalFormat); },
+            [this, name, internalFormat, mipmaps](TextureSource &source) {
+                uploadTexture(name, source, internalFormat, mipmaps);
+            });
     }
 
-    const Texture<GL_TEXTURE_2D> &AssetManager::getTexture(const StaticAssets &name) const {
+    const Texture2D &AssetManager::getTexture(const StaticAssets &name) const {
         auto it = textures.find(name);
         if (it == textures.end())
             throw std::runtime_error("Texture not found: " + std::to_string(static_cast<int>(name)));
         return it->second;
     }
 
+    void AssetManager::loadSpriteArray(const std::vector<std::pair<StaticAssets, std::filesystem::path>> &sprites) {
+        SpriteSheet sheet = packSprites(sprites);
+        uploadSpriteArray(sheet);
+    }
+
+    void AssetManager::loadSpriteArrayAsync(const std::vector<std::pair<StaticAssets, std::filesystem::path>> &sprites) {
+        loader.enqueue<SpriteSheet>(
+            [sprites] { return packSprites(sprites); },
+            [this](SpriteSheet &sheet) { uploadSpriteArray(sheet); });
+    }
+
+    AssetManager::SpriteSheet
+    AssetManager::packSprites(const std::vector<std::pair<StaticAssets, std::filesystem::path>> &sprites) {
+        // Decode every distinct image once
+        SpriteSheet sheet;
+        std::vector<DecodedImage> images;
+        std::unordered_map<std::string, GLint> pathLayers;
+        for (const auto &[name, path]: sprites) {
+            const auto [it, inserted] = pathLayers.try_emplace(path.string(), static_cast<GLint>(images.size()));
+            sheet.layers[name] = it->second;
+            if (!inserted) continue;
+
+            DecodedImage image = DecodedImage::load(path);
+            sheet.layerSize = std::max({sheet.layerSize, image.width, image.height});
+            images.push_back(std::move(image));
+        }
+
+        // Scale all images to the layer size (nearest neighbour)
+        const int layerSize = sheet.layerSize;
+        const size_t layerBytes = static_cast<size_t>(layerSize) * layerSize * 4;
+        sheet.layerCount = static_cast<GLsizei>(images.size());
+        sheet.pixels.resize(layerBytes * images.size());
+        for (size_t i = 0; i < images.size(); ++i) {
+            const auto &image = images[i];
+            unsigned char *layer = sheet.pixels.data() + i * layerBytes;
+            for (int y = 0; y < layerSize; ++y) {
+                const int srcY = y * image.height / layerSize;
+                for (int x = 0; x < layerSize; ++x) {
+                    const int srcX = x * image.width / layerSize;
+                    const size_t src = (static_cast<size_t>(srcY) * image.width + srcX) * 4;
+                    const size_t dst = (static_cast<size_t>(y) * layerSize + x) * 4;
+                    std::copy_n(&image.pixels[src], 4, &layer[dst]);
+                }
+            }
+        }
+        return sheet;
+    }
+
+    void AssetManager::uploadSpriteArray(SpriteSheet &sheet) {
+        if (spriteArray == 0) glGenTextures(1, &spriteArray);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, spriteArray);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_SRGB8_ALPHA8, sheet.layerSize, sheet.layerSize, sheet.layerCount, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, sheet.pixels.data());
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        spriteLayers = std::move(sheet.layers);
+    }
+
+    GLint AssetManager::getSpriteLayer(const StaticAssets &name) const {
+        auto it = spriteLayers.find(name);
+        if (it != spriteLayers.end()) return it->second;
+        it = spriteLayers.find(StaticAssets::MISSING_TEXTURE);
+        return it != spriteLayers.end() ? it->second : 0;
+    }
+
+    std::string AssetManager::meshPathKey(const std::filesystem::path &path) {
+        return path.lexically_normal().string();
+    }
+
     void AssetManager::loadMesh(const StaticAssets &name, const std::string &filepath) {
-        Mesh m;
-        m.load(filepath);
-        meshes[name] = std::move(m);
+        const std::string path = meshPathKey(filepath);
+        if (const auto known = meshPaths.find(path); known != meshPaths.end()) {
+            meshes[name] = &meshFiles.at(known->second);
+            return;
+        }
+        CookedMesh cooked;
+        if (!cooked.load(filepath)) std::cerr << "Failed to load mesh at: " << filepath << std::endl;
+        meshes[name] = &addMesh(path, cooked);
+    }
+
+    StaticMesh &AssetManager::addMesh(const std::string &path, const CookedMesh &cooked) {
+        const auto [it, inserted] = meshFiles.try_emplace(cooked.getKey());
+        if (inserted) it->second.upload(cooked);
+        meshPaths[path] = cooked.getKey();
+        return it->second;
     }
 
     void
     AssetManager::loadShader(const StaticAssets &name, const std::string &vertexPath, const std::string &fragmentPath) {
-        Program p;
-        p.load(vertexPath, fragmentPath);
-        shaders[name] = std::move(p);
+        const std::string key = std::filesystem::path(vertexPath).lexically_normal().string() + '\n' +
+                                std::filesystem::path(fragmentPath).lexically_normal().string();
+        auto [it, inserted] = programs.try_emplace(key);
+        if (inserted) {
+            // Loaded in place, the program cache watches this node for reloads
+            ProgramCache::get().load(it->second.program, vertexPath, fragmentPath);
+            it->second.uniforms = UniformCache(it->second.program);
+        }
+        shaders[name] = &it->second;
     }
 
-    const Mesh &AssetManager::getMesh(const StaticAssets &name) const {
+    const StaticMesh &AssetManager::getMesh(const StaticAssets &name) const {
         auto it = meshes.find(name);
         if (it == meshes.end()) throw std::runtime_error("Mesh not found: " + std::to_string(static_cast<int>(name)));
-        return it->second;
+        return *it->second;
     }
 
     Program &AssetManager::getShader(const StaticAssets &name) {
         auto it = shaders.find(name);
         if (it == shaders.end())
             throw std::runtime_error("Shader not found: " + std::to_string(static_cast<int>(name)));
-        return it->second;
+        return it->second->program;
+    }
+
+    UniformCache &AssetManager::getUniforms(const StaticAssets &name) {
+        auto it = shaders.find(name);
+        if (it == shaders.end())
+            throw std::runtime_error("Shader not found: " + std::to_string(static_cast<int>(name)));
+        return it->second->uniforms;
     }
 
     RenderableAsset AssetManager::getRenderable(const StaticAssets &name) const {
@@ -87,9 +223,8 @@ namespace arcader {
         // Load textures and create a vector of texture names
         std::vector<StaticAssets> textureNames;
         for (size_t i = 0; i < texturePaths.size(); ++i) {
-            auto texName = static_cast<StaticAssets>(static_cast<int>(name) + static_cast<int>(i) +
-                                                             1); // Example mapping
-            loadTexture(texName, texturePaths[i], internalFormat, mipmaps);
+            const StaticAssets texName = textureName(name, i);
+            loadCompressedTexture(texName, texturePaths[i], internalFormat, mipmaps);
             textureNames.push_back(texName);
         }
 
@@ -97,14 +232,60 @@ namespace arcader {
 
     }
 
+    void AssetManager::loadRenderableAsync(const StaticAssets &name,
+                                           const std::filesystem::path &meshPath,
+                                           const std::filesystem::path &vertexShader,
+                                           const std::filesystem::path &fragmentShader,
+                                           const std::vector<std::filesystem::path> &texturePaths,
+                                           GLenum internalFormat,
+                                           GLint mipmaps) {
+        // A mesh file is loaded once, renderables queued later wait for the first load of it
+        const std::string path = meshPathKey(meshPath);
+        if (!meshPaths.contains(path) && pendingMeshFiles.insert(path).second) {
+            loader.enqueue<CookedMesh>(
+                [meshPath] {
+                    CookedMesh cooked;
+                    if (!cooked.load(meshPath)) std::cerr << "Failed to load mesh at: " << meshPath << std::endl;
+                    return cooked;
+                },
+                [this, path](CookedMesh &cooked) {
+                    addMesh(path, cooked);
+                    pendingMeshFiles.erase(path);
+                });
+        }
+
+        // Program linking needs the GL context, it runs with the uploads
+        loader.enqueue([this, name, vertexShader, fragmentShader] {
+            loadShader(name, vertexShader.string(), fragmentShader.string());
+        });
+
+        std::vector<StaticAssets> textureNames;
+        for (size_t i = 0; i < texturePaths.size(); ++i) {
+            textureNames.push_back(textureName(name, i));
+            loadCompressedTextureAsync(textureNames.back(), texturePaths[i], internalFormat, mipmaps);
+        }
+
+        loader.enqueue([this, name, path, textureNames] {
+            meshes[name] = &meshFiles.at(meshPaths.at(path));
+            registerRenderable(name, name, name, textureNames);
+        });
+    }
+
+    StaticAssets AssetManager::textureName(const StaticAssets &name, const size_t index) {
+        return static_cast<StaticAssets>(static_cast<int>(name) + static_cast<int>(index) + 1); // Example mapping
+    }
+
     void AssetManager::registerRenderable(const StaticAssets &name, const StaticAssets &meshName,
                                           const StaticAssets &shaderName,
                                           const std::vector<StaticAssets> &textureNames) {
         RenderableAsset asset;
-        asset.mesh = &meshes.at(meshName);
-        asset.shader = &shaders.at(shaderName);
-        for (const auto &texName: textureNames) {
-            asset.textures.push_back(&textures.at(texName));
+        asset.mesh = meshes.at(meshName);
+        asset.shader = &shaders.at(shaderName)->program;
+        asset.uniforms = &shaders.at(shaderName)->uniforms;
+        asset.shader->use();
+        for (size_t i = 0; i < textureNames.size(); ++i) {
+            asset.textures.push_back(&textures.at(textureNames[i]));
+            asset.shader->bindTextureUnit("tex" + std::to_string(i), static_cast<GLint>(i));
         }
         renderables[name] = std::move(asset);
     }
@@ -113,5 +294,110 @@ namespace arcader {
         return renderables.find(name) != renderables.end();
     }
 
+    void AssetManager::registerInstanced(const StaticAssets &name, const std::vector<StaticAssets> &variants) {
+        const RenderableAsset &first = renderables.at(variants.front());
+        InstancedAsset asset{first.mesh, first.shader, first.uniforms};
+
+        // Copy the variant textures level by level on the GPU side, so the layers match the 2D textures exactly.
+        // Compressed textures keep their blocks and precomputed mip chain, for the others it is generated
+        const auto layers = static_cast<GLsizei>(variants.size());
+        GLint width = 0;
+        GLint height = 0;
+        GLint format = 0;
+        GLint compressed = GL_FALSE;
+        GLint maxLevel = 0;
+        std::vector<unsigned char> pixels;
+        for (size_t i = 0; i < variants.size(); ++i) {
+            const RenderableAsset &variant = renderables.at(variants[i]);
+            if (variant.mesh != asset.mesh || variant.shader != asset.shader || variant.textures.empty())
+                throw std::runtime_error("Renderable cannot be instanced: " +
+                                         std::to_string(static_cast<int>(variants[i])));
+
+            glBindTexture(GL_TEXTURE_2D, variant.textures[0]->handle);
+            GLint layerWidth;
+            GLint layerHeight;
+            GLint layerFormat;
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &layerWidth);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &layerHeight);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &layerFormat);
+            if (i == 0) {
+                width = layerWidth;
+                height = layerHeight;
+                format = layerFormat;
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+                if (compressed) glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+                glGenTextures(1, &asset.textureArray);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, asset.textureArray);
+                for (GLint level = 0; level <= maxLevel; ++level) {
+                    const GLsizei levelWidth = std::max(width >> level, 1);
+                    const GLsizei levelHeight = std::max(height >> level, 1);
+                    if (compressed) {
+                        GLint size;
+                        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+                        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, static_cast<GLenum>(format), levelWidth,
+                                               levelHeight, layers, 0, size * layers, nullptr);
+                    } else {
+                        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, levelWidth, levelHeight, layers, 0, GL_RGBA,
+                                     GL_UNSIGNED_BYTE, nullptr);
+                    }
+                }
+            } else if (layerWidth != width || layerHeight != height || layerFormat != format) {
+                throw std::runtime_error("Instanced textures differ in size or format: " +
+                                         std::to_string(static_cast<int>(variants[i])));
+            }
+
+            for (GLint level = 0; level <= maxLevel; ++level) {
+                const GLsizei levelWidth = std::max(width >> level, 1);
+                const GLsizei levelHeight = std::max(height >> level, 1);
+                if (compressed) {
+                    GLint size;
+                    glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+                    pixels.resize(static_cast<size_t>(size));
+                    glGetCompressedTexImage(GL_TEXTURE_2D, level, pixels.data());
+                    glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, static_cast<GLint>(i), levelWidth,
+                                              levelHeight, 1, static_cast<GLenum>(format), size, pixels.data());
+                } else {
+                    pixels.resize(static_cast<size_t>(levelWidth) * levelHeight * 4);
+                    glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+                    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, static_cast<GLint>(i), levelWidth, levelHeight,
+                                    1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+                }
+            }
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (compressed) glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, maxLevel);
+        else glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        asset.shader->use();
+        asset.uniforms->set("uTextureArray", INSTANCE_TEXTURE_UNIT);
+
+        auto it = instanced.find(name);
+        if (it != instanced.end()) glDeleteTextures(1, &it->second.textureArray);
+        instanced[name] = asset;
+    }
+
+    void AssetManager::renderInstanced(const StaticAssets &name, const glm::mat4 &worldToClip,
+                                       const InstanceBuffer &instances) {
+        auto it = instanced.find(name);
+        if (it == instanced.end()) return;
+        const InstancedAsset &asset = it->second;
+
+        asset.shader->use();
+        asset.uniforms->set("uWorldToClip", worldToClip);
+        asset.uniforms->set("uInstanced", true);
+        glActiveTexture(GL_TEXTURE0 + INSTANCE_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, asset.textureArray);
+        glActiveTexture(GL_TEXTURE0);
+
+        asset.mesh->drawInstanced(instances);
+        asset.uniforms->set("uInstanced", false);
+    }
+
 
 } // arcader
\ No newline at end of file
@@ -1,18 +1,40 @@
 #include "audioPlayer.hpp"
 #include <iostream>
+#include <unordered_map>
 #define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio.h"
 
-static ma_engine engine;
+struct AudioPlayer::Device {
+    ma_engine engine;
+    bool engineInitialized = false;
+    std::unordered_map<std::string, std::unique_ptr<ma_sound>> sounds;
+
+    // The device thread mixes the sounds until the engine is shut down, so it goes before the memory is freed
+    ~Device() {
+        for (auto &[filename, sound] : sounds) ma_sound_uninit(sound.get());
+        if (engineInitialized) ma_engine_uninit(&engine);
+    }
+};
+
+AudioPlayer::AudioPlayer() = default;
+
+AudioPlayer::~AudioPlayer() = default;
 
 void AudioPlayer::init() {
-    ma_result result = ma_engine_init(nullptr, &engine);
+    auto created = std::make_unique<Device>();
+    ma_result result = ma_engine_init(nullptr, &created->engine);
     if (result != MA_SUCCESS) {
         std::cerr << "Failed to initialize audio engine" << std::endl;
+        return;
     }
+    created->engineInitialized = true;
+    device = std::move(created);
 }
 
 void AudioPlayer::play(const std::string& filename, float volume) {
+    if (!device) return;
+    auto &sounds = device->sounds;
+
     // Check if the sound is already loaded
     if (sounds.contains(filename)) {
         ma_sound* s = sounds[filename].get();
@@ -25,7 +47,7 @@ void AudioPlayer::play(const std::string& filename, float volume) {
 
     // Load the sound file
     auto sound = std::make_unique<ma_sound>();
-    ma_result result = ma_sound_init_from_file(&engine, filename.c_str(), MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC, nullptr, nullptr, sound.get());
+    ma_result result = ma_sound_init_from_file(&device->engine, filename.c_str(), MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC, nullptr, nullptr, sound.get());
     if (result != MA_SUCCESS) {
         std::cerr << "Failed to load sound: " << filename << std::endl;
         return;
@@ -38,14 +60,14 @@ void AudioPlayer::play(const std::string& filename, float volume) {
 }
 
 void AudioPlayer::stop(const std::string& filename) {
-    if (sounds.contains(filename)) {
-        ma_sound_stop(sounds[filename].get());
+    if (device && device->sounds.contains(filename)) {
+        ma_sound_stop(device->sounds[filename].get());
     }
 }
 
 bool AudioPlayer::isPlaying(const std::string& filename) const {
-    if (sounds.contains(filename)) {
-        return ma_sound_is_playing(sounds.at(filename).get());
+    if (device && device->sounds.contains(filename)) {
+        return ma_sound_is_playing(device->sounds.at(filename).get());
     }
     return false;
 }
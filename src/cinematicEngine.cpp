@@ -7,8 +7,10 @@
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
-#include <random>
-#include <ctime>
+#include <cmath>
+#include "profiler.hpp"
+#include "programCache.hpp"
+#include "random.hpp"
 
 
 namespace arcader {
@@ -38,7 +40,10 @@ namespace arcader {
         camera.update();
 
         // Particles
-        dustShader.load("shaders/dust.vsh", "shaders/dust.fsh");
+        ProgramCache::get().load(dustShader, "shaders/dust.vsh", "shaders/dust.fsh");
+        dustUniforms = UniformCache(dustShader);
+        dustShader.use();
+        dustUniforms.set("uTex", 0);
         // Dummy white texture for dust particles
         GLuint whiteTex;
         glGenTextures(1, &whiteTex);
@@ -52,7 +57,58 @@ namespace arcader {
 
     }
 
+    void CinematicEngine::preload() {
+        using enum StaticAssets;
+
+        // The variants share mesh and program and only differ in their texture, so all of them are drawn
+        // with one instanced draw
+        static const std::vector<StaticAssets> machines = {
+            ARCADE_MACHINE,
+            ARCADE_MACHINE_2,
+            ARCADE_MACHINE_3,
+            ARCADE_MACHINE_4,
+            ARCADE_MACHINE_5
+        };
+        int z = 1;
+        for (const auto &machine : machines) {
+            std::string texturePath = "assets/textures/Arcade_Color" + std::to_string(z) + ".png";
+            assets->loadRenderableAsync(
+                machine,
+                "assets/meshes/arcade.obj",
+                "shaders/arcade.vsh",
+                "shaders/arcade.fsh",
+                {
+                    texturePath
+                },
+                GL_SRGB8_ALPHA8,
+                Texture2D::FULL_MIP_CHAIN
+            );
+            z += 1;
+        }
+
+        assets->loadRenderableAsync(
+            ROOM,
+            "assets/meshes/newroom.obj",
+            "shaders/arcade.vsh",
+            "shaders/arcade.fsh",
+            {
+                "assets/textures/room_atlas.png",
+            },
+            GL_SRGB8_ALPHA8,
+            Texture2D::FULL_MIP_CHAIN
+        );
+
+        assets->whenLoaded([this] {
+            // Machines and room share the program
+            assets->getShader(ARCADE_MACHINE).use();
+            assets->getUniforms(ARCADE_MACHINE).set("uShadowMap", 1);
+            assets->registerInstanced(ARCADE_MACHINES, machines);
+            placeMachines(machines);
+        });
+    }
+
     void CinematicEngine::update(float deltaTime) {
+        const ProfileScope scope("Update");
         timer += deltaTime;
         updateScene(state, deltaTime);
 
@@ -63,8 +119,9 @@ namespace arcader {
         }
     }
 
-    void CinematicEngine::render() {
-        renderScene(state);
+    void CinematicEngine::render(const float alpha) {
+        const ProfileScope scope("Render", true);
+        renderScene(state, alpha);
     }
 
     void CinematicEngine::reset() {
@@ -90,7 +147,10 @@ namespace arcader {
         // Implement scene-specific updates here
         switch (state) {
             case 0: {
-                dustParticles.update(dt);
+                {
+                    const ProfileScope scope("Dust Update");
+                    dustParticles.update(dt);
+                }
                 lighting.update(glm::vec3(0.0f, -1.0f, -1.0f), glm::vec3(0.1f, 0.15f, 0.25f));
 
                 // Simulate slow camera movement with staged light flicker after 15 seconds
@@ -228,7 +288,7 @@ namespace arcader {
         }
     }
 
-    void CinematicEngine::renderScene(int state) {
+    void CinematicEngine::renderScene(int state, const float alpha) {
         // Implement scene-specific rendering here
         switch (state) {
             case 0:
@@ -240,7 +300,7 @@ namespace arcader {
 
                 break;
             case 2:
-                game->render(camera);
+                game->render(camera, alpha);
                 //game->renderDebug(camera);
                 break;
             case 3:
@@ -253,6 +313,8 @@ namespace arcader {
     }
 
     void CinematicEngine::renderArcade() {
+        cameraBuffer.upload({camera.viewMatrix, camera.projectionMatrix, glm::vec4(camera.worldPosition, 1.0f)});
+
         renderSkybox();
 
         renderShadowPass();
@@ -274,189 +336,125 @@ namespace arcader {
                 y += 4;
             }
         }
+        lighting.upload(cascades);
 
         if (assets) {
             using enum StaticAssets;
 
-            std::vector<StaticAssets> machines = {
-                ARCADE_MACHINE,
-                ARCADE_MACHINE_2,
-                ARCADE_MACHINE_3,
-                ARCADE_MACHINE_4,
-                ARCADE_MACHINE_5
-            };
+            // Machines and room are loaded by preload before the first frame
+            {
+                const ProfileScope scope("Arcade Machines", true);
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, depthMap);
+                glActiveTexture(GL_TEXTURE0);
 
-            // Load arcade machines if not already loaded and bind shaders and lighting
-
-            int z = 1;
-            for(const auto &machine : machines) {
-                if (!assets->hasRenderable(machine)) {
-                    std::string texturePath = "assets/textures/Arcade_Color" + std::to_string(z) + ".png";
-                    assets->loadRenderable(
-                        machine,
-                        "assets/meshes/arcade.obj",
-                        "shaders/arcade.vsh",
-                        "shaders/arcade.fsh",
-                        {
-                            texturePath
-                        }
-                    );
-                    z += 1;
-                }
-                Program &arcadeShader = const_cast<Program &>(assets->getShader(machine));
-                lighting.bindToShader(arcadeShader);
-                lighting.bindPointLightsToShader(arcadeShader);
-                arcadeShader.use();
-                arcadeShader.set("uShadowMap", 1);
-                arcadeShader.set("uLightSpaceMatrix", lightSpaceMatrix);
+                assets->renderInstanced(ARCADE_MACHINES, camera.projectionMatrix * camera.viewMatrix, machineInstances);
             }
 
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, depthMap);
-
-            assets->render(
-                ARCADE_MACHINE,
-                camera.projectionMatrix * camera.viewMatrix,
-                glm::vec3(0.0f, 60.0f, 0.0f), // mittlere Maschine
-                glm::vec3(0.5f)
-            );
-
-            // Arcade machine arrangement shuffle-once per row
-            static std::vector<std::vector<StaticAssets>> shuffledRows;
-            static bool initialized = false;
-            if (!initialized) {
-                for (int i = 0; i < 3; ++i) {
-                    std::vector<StaticAssets> row = {
-                        ARCADE_MACHINE_2,
-                        ARCADE_MACHINE_3,
-                        ARCADE_MACHINE_4,
-                        ARCADE_MACHINE_5
-                    };
-                    std::shuffle(row.begin(), row.end(), std::default_random_engine(static_cast<unsigned>(time(0) + i)));
-                    shuffledRows.push_back(row);
-                }
-                initialized = true;
-            }
-
-            int x = 0;
-            for (int i = 0; i < 3; ++i) {
-                const auto &rowMachines = shuffledRows[i];
-                assets->render(rowMachines[0], camera.projectionMatrix * camera.viewMatrix, glm::vec3(-2.0f, 60.0f, x), glm::vec3(0.5f));
-                assets->render(rowMachines[1], camera.projectionMatrix * camera.viewMatrix, glm::vec3(2.0f, 60.0f, x), glm::vec3(0.5f));
-                assets->render(rowMachines[2], camera.projectionMatrix * camera.viewMatrix, glm::vec3(-4.0f, 60.0f, x), glm::vec3(0.5f));
-                assets->render(rowMachines[3], camera.projectionMatrix * camera.viewMatrix, glm::vec3(4.0f, 60.0f, x), glm::vec3(0.5f));
-                x += 4;
-            }
-
-
             // Render the room
-            if (!assets->hasRenderable(ROOM)) {
-                assets->loadRenderable(
+            {
+                const ProfileScope scope("Room", true);
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, depthMap);
+
+                assets->render(
                     ROOM,
-                    "assets/meshes/newroom.obj",
-                    "shaders/arcade.vsh",
-                    "shaders/arcade.fsh",
-                    {
-                        "assets/textures/room_atlas.png",
-                    }
+                    camera.projectionMatrix * camera.viewMatrix,
+                    glm::vec3(-5.0f, 60.0f, 11.0f), // Room center
+                    glm::vec3(0.06f) // Scale
                 );
             }
 
-            Program &roomShader = const_cast<Program &>(assets->getShader(ROOM));
-            lighting.bindToShader(roomShader);
-            lighting.bindPointLightsToShader(roomShader);
+            // Render dust particles
+            {
+                const ProfileScope scope("Dust Render", true);
+                dustShader.use();
+
+                // Enable blending for dust particles
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                glDisable(GL_DEPTH_TEST);
+
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, dustTexture);
+                dustUniforms.set("uSize", 0.05f);
+                dustUniforms.set("uAlpha", 0.1f);
+                dustParticles.render();
+
+                glEnable(GL_DEPTH_TEST);
+            }
+        }
+    }
 
-            roomShader.use();
-            roomShader.set("uShadowMap", 1);
-            roomShader.set("uLightSpaceMatrix", lightSpaceMatrix);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, depthMap);
+    void CinematicEngine::placeMachines(const std::vector<StaticAssets> &machines) {
+        using enum StaticAssets;
+        const auto instance = [&](const StaticAssets machine, const glm::vec3 &position) {
+            const auto layer = std::ranges::find(machines, machine) - machines.begin();
+            const glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.5f));
+            return MeshInstance{model, static_cast<float>(layer)};
+        };
 
-            assets->render(
-                ROOM,
-                camera.projectionMatrix * camera.viewMatrix,
-                glm::vec3(-5.0f, 60.0f, 11.0f), // Room center
-                glm::vec3(0.06f) // Scale
-            );
+        std::vector<MeshInstance> arrangement;
+        arrangement.push_back(instance(ARCADE_MACHINE, glm::vec3(0.0f, 60.0f, 0.0f))); // mittlere Maschine
 
-            // Render dust particles
-            dustShader.use();
-            dustShader.set("uView", camera.viewMatrix);
-            dustShader.set("uProj", camera.projectionMatrix);
-            dustShader.set("uCameraRight", glm::vec3(camera.viewMatrix[0]));
-            dustShader.set("uCameraUp", glm::vec3(camera.viewMatrix[1]));
-            dustShader.set("uSize", 0.25f);
-
-            // Enable blending for dust particles
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glDisable(GL_DEPTH_TEST);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, dustTexture);
-            dustShader.set("uTex", 0);
-            dustShader.set("uSize", 0.05f);
-            dustShader.set("uAlpha", 0.1f);
-            dustParticles.render();
-
-            glEnable(GL_DEPTH_TEST);
+        // Arcade machine arrangement, shuffled once per row
+        int x = 0;
+        for (int i = 0; i < 3; ++i) {
+            std::vector<StaticAssets> row = {
+                ARCADE_MACHINE_2,
+                ARCADE_MACHINE_3,
+                ARCADE_MACHINE_4,
+                ARCADE_MACHINE_5
+            };
+            Random(Random::hash(arrangementSeed, i)).shuffle(row);
+            arrangement.push_back(instance(row[0], glm::vec3(-2.0f, 60.0f, x)));
+            arrangement.push_back(instance(row[1], glm::vec3(2.0f, 60.0f, x)));
+            arrangement.push_back(instance(row[2], glm::vec3(-4.0f, 60.0f, x)));
+            arrangement.push_back(instance(row[3], glm::vec3(4.0f, 60.0f, x)));
+            x += 4;
         }
+
+        // Shadow casters
+        std::vector<MeshInstance> casters;
+        x = 4;
+        for (int i = 1; i < 3; ++i) {
+            casters.push_back(instance(ARCADE_MACHINE, glm::vec3(-2.0f, 60.0f, x)));
+            casters.push_back(instance(ARCADE_MACHINE, glm::vec3(2.0f, 60.0f, x)));
+            casters.push_back(instance(ARCADE_MACHINE, glm::vec3(-4.0f, 60.0f, x)));
+            casters.push_back(instance(ARCADE_MACHINE, glm::vec3(4.0f, 60.0f, x)));
+            x += 4;
+        }
+
+        // Uploaded once, the draws of every frame only bind the buffers
+        machineInstances.upload(arrangement);
+        shadowInstances.upload(casters);
     }
 
     void CinematicEngine::renderShadowPass() {
+        const ProfileScope scope("Shadow Pass", true);
         // Save current viewport
         GLint prevViewport[4];
         glGetIntegerv(GL_VIEWPORT, prevViewport);
-        glm::vec3 lightDir = glm::normalize(glm::vec3(0.0f, -1.0f, 1.0f));
-
-        glm::mat4 lightProjection = glm::ortho(-50.f, 50.f, -50.f, 50.f, 1.0f, 150.f);
-        glm::mat4 lightView = glm::lookAt(-lightDir * 50.0f, glm::vec3(0.0f), glm::vec3(0, 1, 0));
-        lightSpaceMatrix = lightProjection * lightView;
+        fitCascades();
 
         // Set viewport to shadow map size
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+        glViewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
         glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
         glCullFace(GL_FRONT);
 
-        depthShader.use();
-        depthShader.set("uLightSpaceMatrix", lightSpaceMatrix);
+        // The shadow map must not be sampled while it is rendered to
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glActiveTexture(GL_TEXTURE0);
 
         using enum StaticAssets;
 
-        // Render all arcade machines in shadow pass
-        int x = 4;
-        for (int i = 1; i < 3; ++i) {
-
-            assets->render(
-                    ARCADE_MACHINE,
-                    lightSpaceMatrix,
-                    glm::vec3(-2.0f, 60.0f, x),
-                    glm::vec3(0.5f)
-            );
-
-            assets->render(
-                    ARCADE_MACHINE,
-                    lightSpaceMatrix,
-                    glm::vec3(2.0f, 60.0f, x),
-                    glm::vec3(0.5f)
-            );
-
-            assets->render(
-                    ARCADE_MACHINE,
-                    lightSpaceMatrix,
-                    glm::vec3(-4.0f, 60.0f, x),
-                    glm::vec3(0.5f)
-            );
-
-            assets->render(
-                    ARCADE_MACHINE,
-                    lightSpaceMatrix,
-                    glm::vec3(4.0f, 60.0f, x),
-                    glm::vec3(0.5f)
-            );
-
-            x+=4;
+        // Render all arcade machines into every cascade, the arcade program only has to write depth here
+        for (int cascade = 0; cascade < LightingSystem::SHADOW_CASCADES; ++cascade) {
+            const glm::mat4 &lightSpaceMatrix = cascades.lightSpaceMatrices[cascade];
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap, 0, cascade);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            assets->renderInstanced(ARCADE_MACHINES, lightSpaceMatrix, shadowInstances);
         }
 
         /*if (assets->hasRenderable(ROOM)) {
@@ -475,6 +473,69 @@ namespace arcader {
         glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
     }
 
+    void CinematicEngine::fitCascades() {
+        const glm::vec3 lightDir = glm::normalize(glm::vec3(0.0f, -1.0f, 1.0f));
+        // Only rotates, so light space positions do not change when the camera moves
+        const glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDir, glm::vec3(0, 1, 0));
+
+        // Near and far plane of the perspective projection
+        const glm::mat4 &projection = camera.projectionMatrix;
+        const float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+        const float farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+        const float shadowFar = std::min(farPlane, nearPlane + SHADOW_DISTANCE);
+
+        // Corner rays of the view frustum in world space, from the near to the far plane
+        const glm::mat4 clipToWorld = glm::inverse(projection * camera.viewMatrix);
+        glm::vec3 nearCorners[4];
+        glm::vec3 farCorners[4];
+        for (int i = 0; i < 4; ++i) {
+            const glm::vec2 ndc(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f);
+            const glm::vec4 nearCorner = clipToWorld * glm::vec4(ndc, -1.0f, 1.0f);
+            const glm::vec4 farCorner = clipToWorld * glm::vec4(ndc, 1.0f, 1.0f);
+            nearCorners[i] = glm::vec3(nearCorner) / nearCorner.w;
+            farCorners[i] = glm::vec3(farCorner) / farCorner.w;
+        }
+
+        cascades.splits = glm::vec4(shadowFar);
+        float sliceNear = nearPlane;
+        for (int cascade = 0; cascade < LightingSystem::SHADOW_CASCADES; ++cascade) {
+            // Blend of logarithmic and uniform splits, the near cascades get most of the resolution
+            const float fraction = static_cast<float>(cascade + 1) / LightingSystem::SHADOW_CASCADES;
+            const float logarithmic = nearPlane * std::pow(shadowFar / nearPlane, fraction);
+            const float uniform = nearPlane + (shadowFar - nearPlane) * fraction;
+            const float sliceFar = glm::mix(uniform, logarithmic, SHADOW_SPLIT_BLEND);
+
+            // Bounding sphere of the slice, its size does not depend on the camera orientation
+            glm::vec3 corners[8];
+            glm::vec3 center(0.0f);
+            for (int i = 0; i < 4; ++i) {
+                // View depth grows linearly along a corner ray
+                const float depthRange = farPlane - nearPlane;
+                corners[i] = glm::mix(nearCorners[i], farCorners[i], (sliceNear - nearPlane) / depthRange);
+                corners[i + 4] = glm::mix(nearCorners[i], farCorners[i], (sliceFar - nearPlane) / depthRange);
+                center += (corners[i] + corners[i + 4]) / 8.0f;
+            }
+            float radius = 0.0f;
+            for (const glm::vec3 &corner : corners) radius = std::max(radius, glm::distance(corner, center));
+            radius = std::ceil(radius * 16.0f) / 16.0f; // rounding errors must not change the texel size
+
+            // Snap the center to whole texels in light space
+            const float texel = 2.0f * radius / SHADOW_SIZE;
+            glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+            lightCenter.x = std::floor(lightCenter.x / texel) * texel;
+            lightCenter.y = std::floor(lightCenter.y / texel) * texel;
+
+            // The light looks down -z, near and far are distances in front of it
+            const glm::mat4 lightProjection = glm::ortho(
+                lightCenter.x - radius, lightCenter.x + radius,
+                lightCenter.y - radius, lightCenter.y + radius,
+                -lightCenter.z - radius - SHADOW_CASTER_MARGIN, -lightCenter.z + radius);
+            cascades.lightSpaceMatrices[cascade] = lightProjection * lightView;
+            cascades.splits[cascade] = sliceFar;
+            sliceNear = sliceFar;
+        }
+    }
+
     void CinematicEngine::initShadow() {
         GLint prevViewport[4];
         glGetIntegerv(GL_VIEWPORT, prevViewport);
@@ -483,24 +544,23 @@ namespace arcader {
         glGenFramebuffers(1, &depthMapFBO);
 
         glGenTextures(1, &depthMap);
-        glBindTexture(GL_TEXTURE_2D, depthMap);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
-                     SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, depthMap);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, SHADOW_SIZE, SHADOW_SIZE,
+                     LightingSystem::SHADOW_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
         float borderColor[] = {1.0, 1.0, 1.0, 1.0};
-        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
         glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap, 0, 0);
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
-
-        depthShader.load("shaders/depth.vsh", "shaders/depth.fsh");
     }
 
     GLuint CinematicEngine::loadCubemap(const std::vector<std::string>& faces) {
@@ -603,17 +663,16 @@ namespace arcader {
 
         cubemapTexture = loadCubemap(faces);
 
-        skyboxShader.load("shaders/skybox.vsh", "shaders/skybox.fsh");
+        ProgramCache::get().load(skyboxShader, "shaders/skybox.vsh", "shaders/skybox.fsh");
+        UniformCache::bindBlocks(skyboxShader);
         this->skyboxVAO = skyboxVAO;
         this->cubemapTexture = cubemapTexture;
     }
 
     void CinematicEngine::renderSkybox() {
+        const ProfileScope scope("Skybox", true);
         glDepthFunc(GL_LEQUAL);
-        skyboxShader.use();
-        glm::mat4 view = glm::mat4(glm::mat3(camera.viewMatrix));
-        skyboxShader.set("uView", view);
-        skyboxShader.set("uProjection", camera.projectionMatrix);
+        skyboxShader.use(); // camera from the uniform block, the shader drops the translation itself
 
         glBindVertexArray(skyboxVAO);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
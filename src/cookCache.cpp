@@ -0,0 +1,69 @@
+#include "cookCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include "mappedFile.hpp"
+#include "random.hpp"
+
+namespace arcader {
+
+    std::optional<uint64_t> CookCache::hashFile(const std::filesystem::path &path) {
+        MappedFile file;
+        if (!file.open(path)) return std::nullopt;
+        return hashBytes(file.data(), file.size());
+    }
+
+    uint64_t CookCache::hashBytes(const void *data, const size_t size) {
+        // Four independent lanes of multiply-xorshift keep the multipliers busy, the lanes are mixed at the end
+        constexpr uint64_t prime = 0x9e3779b97f4a7c15ull;
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        uint64_t lanes[4] = {1, 2, 3, 4};
+        size_t offset = 0;
+        for (; offset + 32 <= size; offset += 32) {
+            for (int lane = 0; lane < 4; ++lane) {
+                uint64_t word;
+                std::memcpy(&word, bytes + offset + lane * 8, 8);
+                lanes[lane] = (lanes[lane] ^ word) * prime;
+                lanes[lane] ^= lanes[lane] >> 29;
+            }
+        }
+        for (; offset + 8 <= size; offset += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + offset, 8);
+            lanes[0] = (lanes[0] ^ word) * prime;
+            lanes[0] ^= lanes[0] >> 29;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, bytes + offset, size - offset);
+        return Random::hash(lanes[0], lanes[1], lanes[2], lanes[3], tail, size);
+    }
+
+    std::filesystem::path CookCache::cookedPath(const uint64_t key, const char *extension) {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        std::filesystem::path path = std::filesystem::path("cache") / name;
+        path += extension;
+        return path;
+    }
+
+    bool CookCache::write(const std::filesystem::path &cooked, const std::vector<std::byte> &bytes) {
+        std::error_code error;
+        std::filesystem::create_directories(cooked.parent_path(), error);
+        // Unique per writer, two threads or instances cooking the same artefact write identical files
+        std::filesystem::path temporary = cooked;
+        temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!out) return false;
+        }
+        std::filesystem::rename(temporary, cooked, error);
+        if (error) std::filesystem::remove(temporary, error);
+        return std::filesystem::exists(cooked);
+    }
+
+} // arcader
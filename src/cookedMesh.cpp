@@ -0,0 +1,96 @@
+#include "cookedMesh.hpp"
+
+#include <bit>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include "cookCache.hpp"
+#include "random.hpp"
+
+namespace arcader {
+
+    static_assert(std::endian::native == std::endian::little, "Cooked meshes are stored little endian");
+    static_assert(sizeof(CookedMeshHeader) == 44 && sizeof(MeshVertex) == 32,
+                  "Cooked mesh layout changed, increase CookedMesh::VERSION");
+
+    std::optional<uint64_t> CookedMesh::cacheKey(const std::filesystem::path &objPath) {
+        const auto source = CookCache::hashFile(objPath);
+        if (!source) return std::nullopt;
+        return Random::hash(*source, VERSION);
+    }
+
+    std::vector<std::byte> CookedMesh::encode(const MeshData &data) {
+        const auto &[meshVertices, meshIndices] = data;
+
+        CookedMeshHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.vertexCount = static_cast<uint32_t>(meshVertices.size());
+        header.indexCount = static_cast<uint32_t>(meshIndices.size());
+        header.indexSize = meshVertices.size() <= std::numeric_limits<uint16_t>::max() + size_t{1} ? 2 : 4;
+        header.bounds = data.computeBounds();
+
+        const size_t vertexBytes = meshVertices.size() * sizeof(MeshVertex);
+        std::vector<std::byte> bytes(sizeof(header) + vertexBytes + meshIndices.size() * header.indexSize);
+        std::byte *out = bytes.data();
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        if (vertexBytes > 0) std::memcpy(out, meshVertices.data(), vertexBytes);
+        out += vertexBytes;
+        if (header.indexSize == 2) {
+            for (const GLuint index: meshIndices) {
+                const auto shortIndex = static_cast<uint16_t>(index);
+                std::memcpy(out, &shortIndex, sizeof(shortIndex));
+                out += sizeof(shortIndex);
+            }
+        } else if (!meshIndices.empty()) {
+            std::memcpy(out, meshIndices.data(), meshIndices.size() * sizeof(GLuint));
+        }
+        return bytes;
+    }
+
+    bool CookedMesh::cook(const std::filesystem::path &objPath) {
+        const auto cookKey = cacheKey(objPath);
+        MeshData data;
+        if (!cookKey || !StaticMesh::parseObj(objPath, data)) return false;
+        return CookCache::write(CookCache::cookedPath(*cookKey, ".mesh"), encode(data));
+    }
+
+    bool CookedMesh::load(const std::filesystem::path &objPath) {
+        const auto cookKey = cacheKey(objPath);
+        if (!cookKey) return false;
+        key = *cookKey;
+        const std::filesystem::path cooked = CookCache::cookedPath(key, ".mesh");
+        if (file.open(cooked)) {
+            if (view(file.data(), file.size())) return true;
+            file.close();
+        }
+
+        MeshData data;
+        if (!StaticMesh::parseObj(objPath, data)) return false;
+        image = encode(data);
+        if (!CookCache::write(cooked, image)) std::cerr << "Failed to write cooked mesh at: " << cooked << std::endl;
+        return view(image.data(), image.size());
+    }
+
+    bool CookedMesh::view(const std::byte *data, const size_t size) {
+        CookedMeshHeader header;
+        if (size < sizeof(header)) return false;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) return false;
+        if (header.indexSize != 2 && header.indexSize != 4) return false;
+        const uint64_t vertexBytes = uint64_t{header.vertexCount} * sizeof(MeshVertex);
+        const uint64_t indexBytes = uint64_t{header.indexCount} * header.indexSize;
+        if (size != sizeof(header) + vertexBytes + indexBytes) return false;
+
+        vertices = reinterpret_cast<const MeshVertex *>(data + sizeof(header));
+        indices = data + sizeof(header) + vertexBytes;
+        vertexCount = static_cast<GLsizei>(header.vertexCount);
+        indexCount = static_cast<GLsizei>(header.indexCount);
+        indexType = header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        bounds = header.bounds;
+        return true;
+    }
+
+} // arcader
@@ -0,0 +1,428 @@
+#include "cookedTexture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include "cookCache.hpp"
+#include "random.hpp"
+
+namespace arcader {
+
+    static_assert(std::endian::native == std::endian::little, "Cooked textures are stored little endian");
+
+    namespace {
+        constexpr uint32_t fourCC(const char a, const char b, const char c, const char d) {
+            return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+                   static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8 |
+                   static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16 |
+                   static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24;
+        }
+
+        /**
+         * Magic number and DDS_HEADER, only the fields needed for block compressed 2D textures are used.
+         */
+        struct DdsHeader {
+            uint32_t magic;
+            uint32_t size;
+            uint32_t flags;
+            uint32_t height;
+            uint32_t width;
+            uint32_t pitchOrLinearSize;
+            uint32_t depth;
+            uint32_t mipMapCount;
+            uint32_t reserved1[11]; // [0] cook tag, [1] cook version
+            uint32_t pixelFormatSize;
+            uint32_t pixelFormatFlags;
+            uint32_t fourCC;
+            uint32_t rgbBitCount;
+            uint32_t bitMasks[4];
+            uint32_t caps[4];
+            uint32_t reserved2;
+        };
+
+        static_assert(sizeof(DdsHeader) == 128);
+
+        constexpr uint32_t DDS_MAGIC = fourCC('D', 'D', 'S', ' ');
+        constexpr uint32_t COOK_TAG = fourCC('A', 'R', 'C', 'D'); // marks files written by CookedTexture
+        constexpr uint32_t DDSD_FLAGS = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // caps, size, format, mips
+        constexpr uint32_t DDPF_FOURCC = 0x4;
+        constexpr uint32_t DDSCAPS_FLAGS = 0x8 | 0x1000 | 0x400000; // complex, texture, mipmap
+        constexpr uint32_t FOURCC_DXT1 = fourCC('D', 'X', 'T', '1');
+        constexpr uint32_t FOURCC_DXT5 = fourCC('D', 'X', 'T', '5');
+
+        using Block = std::array<std::array<uint8_t, 4>, 16>; // 4x4 RGBA texels, row by row
+
+        size_t blockBytes(const CookedTexture::Format format) {
+            return format == CookedTexture::Format::BC1 ? 8 : 16;
+        }
+
+        size_t levelSize(const int width, const int height, const CookedTexture::Format format) {
+            return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+        }
+
+        const std::array<float, 256> &srgbToLinear() {
+            static const std::array<float, 256> table = [] {
+                std::array<float, 256> values{};
+                for (int i = 0; i < 256; ++i) {
+                    const float c = static_cast<float>(i) / 255.0f;
+                    values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        uint8_t linearToSrgb(const float linear) {
+            const float c = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+
+        /**
+         * Half the size of an sRGB image (at least 1), averaging 2x2 texels in linear space.
+         */
+        DecodedImage downsample(const DecodedImage &image) {
+            const auto &toLinear = srgbToLinear();
+            DecodedImage half{std::max(image.width / 2, 1), std::max(image.height / 2, 1), {}};
+            half.pixels.resize(static_cast<size_t>(half.width) * half.height * 4);
+            for (int y = 0; y < half.height; ++y) {
+                const int y0 = std::min(2 * y, image.height - 1);
+                const int y1 = std::min(2 * y + 1, image.height - 1);
+                for (int x = 0; x < half.width; ++x) {
+                    const int x0 = std::min(2 * x, image.width - 1);
+                    const int x1 = std::min(2 * x + 1, image.width - 1);
+                    const unsigned char *texels[4] = {
+                        &image.pixels[(static_cast<size_t>(y0) * image.width + x0) * 4],
+                        &image.pixels[(static_cast<size_t>(y0) * image.width + x1) * 4],
+                        &image.pixels[(static_cast<size_t>(y1) * image.width + x0) * 4],
+                        &image.pixels[(static_cast<size_t>(y1) * image.width + x1) * 4]
+                    };
+                    unsigned char *out = &half.pixels[(static_cast<size_t>(y) * half.width + x) * 4];
+                    for (int c = 0; c < 3; ++c) {
+                        float sum = 0.0f;
+                        for (const unsigned char *texel: texels) sum += toLinear[texel[c]];
+                        out[c] = linearToSrgb(sum * 0.25f);
+                    }
+                    int alpha = 0;
+                    for (const unsigned char *texel: texels) alpha += texel[3];
+                    out[3] = static_cast<uint8_t>((alpha + 2) / 4);
+                }
+            }
+            return half;
+        }
+
+        uint16_t pack565(const float color[3]) {
+            const auto channel = [](const float value, const int max) {
+                return std::clamp(static_cast<int>(value * static_cast<float>(max) / 255.0f + 0.5f), 0, max);
+            };
+            return static_cast<uint16_t>(channel(color[0], 31) << 11 | channel(color[1], 63) << 5 |
+                                         channel(color[2], 31));
+        }
+
+        std::array<int, 3> unpack565(const uint16_t packed) {
+            const int r = packed >> 11 & 31;
+            const int g = packed >> 5 & 63;
+            const int b = packed & 31;
+            return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+        }
+
+        /**
+         * Endpoints and the two interpolated colors of a color block, alpha 0 marks the transparent entry.
+         */
+        std::array<std::array<int, 4>, 4> colorPalette(const uint16_t c0, const uint16_t c1, const bool fourColors) {
+            const auto p0 = unpack565(c0);
+            const auto p1 = unpack565(c1);
+            std::array<std::array<int, 4>, 4> palette{};
+            for (int c = 0; c < 3; ++c) {
+                palette[0][c] = p0[c];
+                palette[1][c] = p1[c];
+                palette[2][c] = fourColors ? (2 * p0[c] + p1[c]) / 3 : (p0[c] + p1[c]) / 2;
+                palette[3][c] = fourColors ? (p0[c] + 2 * p1[c]) / 3 : 0;
+            }
+            palette[0][3] = palette[1][3] = palette[2][3] = 255;
+            palette[3][3] = fourColors ? 255 : 0;
+            return palette;
+        }
+
+        /**
+         * Encode the colors of a block: endpoints on the principal axis of the texel colors, inset a little,
+         * and the closest palette entry for each texel. Always uses the four color mode.
+         */
+        void encodeColors(const Block &block, std::byte *out) {
+            float mean[3]{};
+            for (const auto &texel: block)
+                for (int c = 0; c < 3; ++c) mean[c] += texel[c] / 16.0f;
+
+            float covariance[3][3]{};
+            for (const auto &texel: block) {
+                const float d[3] = {texel[0] - mean[0], texel[1] - mean[1], texel[2] - mean[2]};
+                for (int i = 0; i < 3; ++i)
+                    for (int j = 0; j < 3; ++j) covariance[i][j] += d[i] * d[j];
+            }
+
+            // Power iteration converges to the principal axis quickly enough for 16 texels
+            float axis[3] = {1.0f, 1.0f, 1.0f};
+            for (int iteration = 0; iteration < 4; ++iteration) {
+                float next[3]{};
+                for (int i = 0; i < 3; ++i)
+                    for (int j = 0; j < 3; ++j) next[i] += covariance[i][j] * axis[j];
+                const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+                if (length < 1e-6f) break;
+                for (int i = 0; i < 3; ++i) axis[i] = next[i] / length;
+            }
+            const float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            for (float &value: axis) value /= axisLength;
+
+            float minT = 0.0f;
+            float maxT = 0.0f;
+            for (const auto &texel: block) {
+                float t = 0.0f;
+                for (int c = 0; c < 3; ++c) t += (texel[c] - mean[c]) * axis[c];
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+            const float inset = (maxT - minT) / 16.0f;
+            float high[3];
+            float low[3];
+            for (int c = 0; c < 3; ++c) {
+                high[c] = mean[c] + axis[c] * (maxT - inset);
+                low[c] = mean[c] + axis[c] * (minT + inset);
+            }
+
+            uint16_t c0 = pack565(high);
+            uint16_t c1 = pack565(low);
+            if (c0 < c1) std::swap(c0, c1);
+            uint32_t indices = 0;
+            if (c0 != c1) {
+                const auto palette = colorPalette(c0, c1, true);
+                for (int i = 0; i < 16; ++i) {
+                    int best = 0;
+                    int bestDistance = std::numeric_limits<int>::max();
+                    for (int entry = 0; entry < 4; ++entry) {
+                        int distance = 0;
+                        for (int c = 0; c < 3; ++c) {
+                            const int d = block[i][c] - palette[entry][c];
+                            distance += d * d;
+                        }
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            best = entry;
+                        }
+                    }
+                    indices |= static_cast<uint32_t>(best) << (2 * i);
+                }
+            }
+            std::memcpy(out, &c0, 2);
+            std::memcpy(out + 2, &c1, 2);
+            std::memcpy(out + 4, &indices, 4);
+        }
+
+        std::array<int, 8> alphaPalette(const int a0, const int a1) {
+            std::array<int, 8> palette{a0, a1};
+            if (a0 > a1) {
+                for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+            } else {
+                for (int i = 2; i < 6; ++i) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+            return palette;
+        }
+
+        /**
+         * Encode the alpha of a block between its minimum and maximum with the eight value mode.
+         */
+        void encodeAlpha(const Block &block, std::byte *out) {
+            uint8_t a0 = 0;
+            uint8_t a1 = 255;
+            for (const auto &texel: block) {
+                a0 = std::max(a0, texel[3]);
+                a1 = std::min(a1, texel[3]);
+            }
+            uint64_t indices = 0;
+            if (a0 != a1) {
+                const auto palette = alphaPalette(a0, a1);
+                for (int i = 0; i < 16; ++i) {
+                    int best = 0;
+                    for (int entry = 1; entry < 8; ++entry) {
+                        if (std::abs(block[i][3] - palette[entry]) < std::abs(block[i][3] - palette[best])) best = entry;
+                    }
+                    indices |= static_cast<uint64_t>(best) << (3 * i);
+                }
+            }
+            out[0] = static_cast<std::byte>(a0);
+            out[1] = static_cast<std::byte>(a1);
+            std::memcpy(out + 2, &indices, 6);
+        }
+
+        void decodeColors(const std::byte *in, const bool alwaysFourColors, Block &block) {
+            uint16_t c0;
+            uint16_t c1;
+            uint32_t indices;
+            std::memcpy(&c0, in, 2);
+            std::memcpy(&c1, in + 2, 2);
+            std::memcpy(&indices, in + 4, 4);
+            const auto palette = colorPalette(c0, c1, alwaysFourColors || c0 > c1);
+            for (int i = 0; i < 16; ++i) {
+                const auto &entry = palette[indices >> (2 * i) & 3];
+                for (int c = 0; c < 4; ++c) block[i][c] = static_cast<uint8_t>(entry[c]);
+            }
+        }
+
+        void decodeAlpha(const std::byte *in, Block &block) {
+            uint64_t indices = 0;
+            std::memcpy(&indices, in + 2, 6);
+            const auto palette = alphaPalette(std::to_integer<int>(in[0]), std::to_integer<int>(in[1]));
+            for (int i = 0; i < 16; ++i) block[i][3] = static_cast<uint8_t>(palette[indices >> (3 * i) & 7]);
+        }
+
+        void compressLevel(const DecodedImage &level, const CookedTexture::Format format, std::byte *out) {
+            Block block;
+            for (int blockY = 0; blockY < level.height; blockY += 4) {
+                for (int blockX = 0; blockX < level.width; blockX += 4) {
+                    // Texels outside of small levels repeat the edge
+                    for (int i = 0; i < 16; ++i) {
+                        const int x = std::min(blockX + i % 4, level.width - 1);
+                        const int y = std::min(blockY + i / 4, level.height - 1);
+                        std::memcpy(block[i].data(), &level.pixels[(static_cast<size_t>(y) * level.width + x) * 4], 4);
+                    }
+                    if (format == CookedTexture::Format::BC3) {
+                        encodeAlpha(block, out);
+                        out += 8;
+                    }
+                    encodeColors(block, out);
+                    out += 8;
+                }
+            }
+        }
+    }
+
+    std::optional<uint64_t> CookedTexture::cacheKey(const std::filesystem::path &imagePath) {
+        const auto source = CookCache::hashFile(imagePath);
+        if (!source) return std::nullopt;
+        return Random::hash(*source, VERSION);
+    }
+
+    std::vector<std::byte> CookedTexture::encode(const DecodedImage &image) {
+        bool opaque = true;
+        for (size_t i = 3; i < image.pixels.size() && opaque; i += 4) opaque = image.pixels[i] == 255;
+        const Format format = opaque ? Format::BC1 : Format::BC3;
+
+        uint32_t levelCount = 1;
+        size_t size = sizeof(DdsHeader) + levelSize(image.width, image.height, format);
+        for (int width = image.width, height = image.height; width > 1 || height > 1; ++levelCount) {
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+            size += levelSize(width, height, format);
+        }
+
+        DdsHeader header{};
+        header.magic = DDS_MAGIC;
+        header.size = sizeof(DdsHeader) - sizeof(header.magic);
+        header.flags = DDSD_FLAGS;
+        header.height = static_cast<uint32_t>(image.height);
+        header.width = static_cast<uint32_t>(image.width);
+        header.pitchOrLinearSize = static_cast<uint32_t>(levelSize(image.width, image.height, format));
+        header.mipMapCount = levelCount;
+        header.reserved1[0] = COOK_TAG;
+        header.reserved1[1] = VERSION;
+        header.pixelFormatSize = 32;
+        header.pixelFormatFlags = DDPF_FOURCC;
+        header.fourCC = format == Format::BC1 ? FOURCC_DXT1 : FOURCC_DXT5;
+        header.caps[0] = DDSCAPS_FLAGS;
+
+        std::vector<std::byte> bytes(size);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::byte *out = bytes.data() + sizeof(header);
+        compressLevel(image, format, out);
+        out += levelSize(image.width, image.height, format);
+        for (DecodedImage level = image; level.width > 1 || level.height > 1;) {
+            level = downsample(level);
+            compressLevel(level, format, out);
+            out += levelSize(level.width, level.height, format);
+        }
+        return bytes;
+    }
+
+    bool CookedTexture::cook(const std::filesystem::path &imagePath) {
+        const auto key = cacheKey(imagePath);
+        if (!key) return false;
+        return CookCache::write(CookCache::cookedPath(*key, ".dds"), encode(DecodedImage::load(imagePath)));
+    }
+
+    bool CookedTexture::load(const std::filesystem::path &imagePath) {
+        const auto key = cacheKey(imagePath);
+        if (!key) return false;
+        const std::filesystem::path cooked = CookCache::cookedPath(*key, ".dds");
+        if (file.open(cooked)) {
+            if (view(file.data(), file.size())) return true;
+            file.close();
+        }
+
+        image = encode(DecodedImage::load(imagePath));
+        if (!CookCache::write(cooked, image)) std::cerr << "Failed to write cooked texture at: " << cooked << std::endl;
+        return view(image.data(), image.size());
+    }
+
+    bool CookedTexture::view(const std::byte *data, const size_t size) {
+        levels.clear();
+        DdsHeader header;
+        if (size < sizeof(header)) return false;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != DDS_MAGIC || header.reserved1[0] != COOK_TAG || header.reserved1[1] != VERSION)
+            return false;
+        if (header.fourCC != FOURCC_DXT1 && header.fourCC != FOURCC_DXT5) return false;
+        if (header.width == 0 || header.height == 0 || header.mipMapCount == 0 || header.mipMapCount > 32)
+            return false;
+        format = header.fourCC == FOURCC_DXT1 ? Format::BC1 : Format::BC3;
+
+        size_t offset = sizeof(header);
+        int width = static_cast<int>(header.width);
+        int height = static_cast<int>(header.height);
+        for (uint32_t level = 0; level < header.mipMapCount; ++level) {
+            const size_t bytes = levelSize(width, height, format);
+            if (offset + bytes > size) {
+                levels.clear();
+                return false;
+            }
+            levels.push_back({width, height, data + offset, bytes});
+            offset += bytes;
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+        }
+        return true;
+    }
+
+    DecodedImage CookedTexture::decode(const size_t level) const {
+        const Level &source = levels.at(level);
+        DecodedImage decoded{source.width, source.height, {}};
+        decoded.pixels.resize(static_cast<size_t>(source.width) * source.height * 4);
+
+        const std::byte *in = source.blocks;
+        Block block;
+        for (int blockY = 0; blockY < source.height; blockY += 4) {
+            for (int blockX = 0; blockX < source.width; blockX += 4) {
+                if (format == Format::BC3) {
+                    decodeColors(in + 8, true, block);
+                    decodeAlpha(in, block);
+                    in += 16;
+                } else {
+                    decodeColors(in, false, block);
+                    in += 8;
+                }
+                for (int i = 0; i < 16; ++i) {
+                    const int x = blockX + i % 4;
+                    const int y = blockY + i / 4;
+                    if (x >= source.width || y >= source.height) continue;
+                    std::memcpy(&decoded.pixels[(static_cast<size_t>(y) * source.width + x) * 4], block[i].data(), 4);
+                }
+            }
+        }
+        return decoded;
+    }
+
+} // arcader
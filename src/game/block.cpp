@@ -4,7 +4,12 @@
 
 #include "game/block.hpp"
 
-#include "assetManager.hpp"
+#include <cmath>
+#include <cstdio>
+
+#include "game/blockScheduler.hpp"
+#include "game/waterSimulation.hpp"
+#include "game/world.hpp"
 
 namespace arcader {
 std::vector<BlockType> BlockStates::getBlockTypes() {
@@ -53,24 +58,52 @@ bool BlockStates::isSolid(const BlockType &type) {
     return type != BlockType::AIR && type != BlockType::WATER;
 }
 
-bool BlockStates::isColliding(const glm::vec2 &pos, const std::vector<std::vector<Block> > &blocks) {
-    const int x = static_cast<int>(pos.x);
-    const int y = static_cast<int>(pos.y);
+uint32_t BlockStates::getTickDelay(const BlockType &type) {
+    switch (type) {
+        case BlockType::WATER: return 2;
+        case BlockType::GRASS: return 20;
+        default: return 0;
+    }
+}
+
+void BlockStates::update(World &world, const glm::ivec2 pos, BlockScheduler &scheduler) {
+    // The column may have been unloaded since the update was scheduled, its slot belongs to another column now
+    if (!world.isInBounds(pos.x, pos.y)) return;
+    switch (world.get(pos.x, pos.y)) {
+        case BlockType::WATER:
+            WaterSimulation::update(world, pos, scheduler);
+            break;
+
+        case BlockType::GRASS:
+            // Grass decays when something covers it
+            if (world.getBlock(pos.x, pos.y + 1) == BlockType::AIR) break;
+            world.set(pos.x, pos.y, BlockType::DIRT);
+            scheduler.scheduleNeighbourhood(world, pos);
+            break;
+
+        default: break;
+    }
+}
+
+bool BlockStates::isColliding(const glm::vec2 &pos, const World &world) {
+    const int x = static_cast<int>(std::floor(pos.x));
+    const int y = static_cast<int>(std::floor(pos.y));
 
-    if (x < 0 || x >= blocks.size() || y < 0 || y >= blocks[0].size()) {
+    if (!world.isInBounds(x, y)) {
         return true; // Outside bounds = solid
     }
 
-    return isSolid(blocks[x][y].type);
+    return isSolid(world.get(x, y));
 }
 
-int BlockStates::getHighestBlock(const bool ignoreLeaves, const int x, const std::vector<std::vector<Block> > &blocks) {
-    for (int y = 31; y < blocks[x].size(); --y) {
-        auto type = blocks[x][y].type;
+int BlockStates::getHighestBlock(const bool ignoreLeaves, const int x, const World &world) {
+    if (!world.isLoaded(World::toChunk(x))) return 0;
+    for (int y = world.getHeight() - 1; y >= 0; --y) {
+        auto type = world.get(x, y);
         if (isSolid(type)) {
             if (ignoreLeaves && type == BlockType::LEAVES) {
                 // check if under leaves is a non-solid
-                const auto subBlock = blocks[x][y - 1].type;
+                const auto subBlock = world.getBlock(x, y - 1);
                 if (isSolid(subBlock)) return y; // No free space underneath leaves (double leaves appear very rare, so not worth the check cost)
             }
             return y;
@@ -79,7 +112,7 @@ int BlockStates::getHighestBlock(const bool ignoreLeaves, const int x, const std
     return 0; // No solid block found
 }
 
-bool BlockStates::isInBounds(const glm::uvec2 pos, const std::vector<std::vector<Block>> &blocks) {
-    return pos.x < blocks.size() && pos.y < blocks[0].size();
+bool BlockStates::isInBounds(const glm::ivec2 pos, const World &world) {
+    return world.isInBounds(pos.x, pos.y);
 }
 }
@@ -0,0 +1,91 @@
+#include "game/blockScheduler.hpp"
+
+#include <algorithm>
+
+#include "game/block.hpp"
+
+namespace arcader {
+
+void BlockScheduler::schedule(const glm::ivec2 pos, const uint32_t delay) {
+    if (!insertPending(key(pos.x, pos.y))) return; // already waiting
+    queue.push_back({currentTick + std::max(delay, 1u), pos.y, pos.x});
+    std::ranges::push_heap(queue, later);
+}
+
+void BlockScheduler::scheduleNeighbourhood(const World &world, const glm::ivec2 pos) {
+    for (const glm::ivec2 offset : {glm::ivec2(0, 0), glm::ivec2(0, -1), glm::ivec2(0, 1),
+                                    glm::ivec2(-1, 0), glm::ivec2(1, 0)}) {
+        const glm::ivec2 p = pos + offset;
+        if (!world.isInBounds(p.x, p.y)) continue;
+        if (const uint32_t delay = BlockStates::getTickDelay(world.get(p.x, p.y)); delay > 0) schedule(p, delay);
+    }
+}
+
+bool BlockScheduler::popDue(glm::ivec2 &pos) {
+    if (queue.empty() || queue.front().due > currentTick) return false;
+    std::ranges::pop_heap(queue, later);
+    const Entry entry = queue.back();
+    queue.pop_back();
+    erasePending(key(entry.x, entry.y));
+    pos = {entry.x, entry.y};
+    return true;
+}
+
+void BlockScheduler::clear() {
+    queue.clear();
+    std::ranges::fill(pending, EMPTY);
+    pendingCount = 0;
+}
+
+void BlockScheduler::clearColumn(const int chunkX) {
+    const auto removed = std::ranges::remove_if(queue, [&](const Entry &entry) {
+        if (World::toChunk(entry.x) != chunkX) return false;
+        erasePending(key(entry.x, entry.y));
+        return true;
+    });
+    if (removed.empty()) return;
+    queue.erase(removed.begin(), removed.end());
+    std::ranges::make_heap(queue, later);
+}
+
+size_t BlockScheduler::probe(const uint64_t k) const {
+    const size_t mask = pending.size() - 1;
+    size_t i = home(k);
+    while (pending[i] != EMPTY && pending[i] != k) i = (i + 1) & mask;
+    return i;
+}
+
+bool BlockScheduler::insertPending(const uint64_t k) {
+    if ((pendingCount + 1) * 2 > pending.size()) growPending(); // keep the load factor below one half
+    const size_t i = probe(k);
+    if (pending[i] == k) return false;
+    pending[i] = k;
+    ++pendingCount;
+    return true;
+}
+
+void BlockScheduler::erasePending(const uint64_t k) {
+    const size_t mask = pending.size() - 1;
+    size_t hole = probe(k);
+    if (pending[hole] != k) return;
+    pending[hole] = EMPTY;
+    --pendingCount;
+
+    // Shift back following keys of the cluster that would no longer be found past the hole
+    for (size_t i = (hole + 1) & mask; pending[i] != EMPTY; i = (i + 1) & mask) {
+        if (((i - home(pending[i])) & mask) >= ((i - hole) & mask)) {
+            pending[hole] = pending[i];
+            pending[i] = EMPTY;
+            hole = i;
+        }
+    }
+}
+
+void BlockScheduler::growPending() {
+    std::vector<uint64_t> old(std::max<size_t>(pending.size() * 2, 256), EMPTY);
+    old.swap(pending);
+    for (const uint64_t k : old) {
+        if (k != EMPTY) pending[probe(k)] = k;
+    }
+}
+} // arcader
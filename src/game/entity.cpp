@@ -4,10 +4,10 @@
 
 #include "game/entity.hpp"
 
+#include <cmath>
+
 #include "audioPlayer.hpp"
-#include "framework/app.hpp"
 #include "game/block.hpp"
-#include "glm/detail/_noise.hpp"
 
 namespace arcader {
 /*
@@ -30,19 +30,22 @@ Entity::Entity(const EntityType type, const float width, const float height, con
     direction(false),
     currentSprite(startSprite),
     position(position),
-    velocity(vec2(0.0, 0.0)) {
+    previousPosition(position),
+    velocity(glm::vec2(0.0, 0.0)) {
 }
 
 bool canJump = true;
 
-void EntityPlayer::update(const float deltaTime, const std::vector<std::vector<Block>>& blocks, AudioPlayer& audioPlayer) {
+void EntityPlayer::update(const float deltaTime, const World& world, AudioPlayer& audioPlayer) {
     constexpr float gravity = -8.0f;
     constexpr float maxFallSpeed = -5.0f;
+    constexpr float frictionRate = 60.0f; // friction factors were tuned per frame at 60 fps
+    const float friction = std::pow(0.8f, deltaTime * frictionRate);
 
     // React to input
     const int curX = static_cast<int>(std::floor(position.x));
     const int curY = static_cast<int>(std::floor(position.y));
-    const bool isInWater = blocks[curX][curY].type == BlockType::WATER;
+    const bool isInWater = world.getBlock(curX, curY) == BlockType::WATER;
     if (isJumping) {
         if (isInWater) velocity.y = 1.0f;
         else if (velocity.y == 0.0f) {
@@ -77,7 +80,7 @@ void EntityPlayer::update(const float deltaTime, const std::vector<std::vector<B
 
     bool xBlocked = false;
     for (int y = startY; y <= endY; ++y) {
-        if (BlockStates::isColliding({ checkX, y }, blocks)) {
+        if (BlockStates::isColliding({ checkX, y }, world)) {
             xBlocked = true;
             break;
         }
@@ -101,7 +104,7 @@ void EntityPlayer::update(const float deltaTime, const std::vector<std::vector<B
 
     bool yBlocked = false;
     for (int x = startX; x <= endX; ++x) {
-        if (BlockStates::isColliding({ x, checkY }, blocks)) {
+        if (BlockStates::isColliding({ x, checkY }, world)) {
             yBlocked = true;
             break;
         }
@@ -116,7 +119,7 @@ void EntityPlayer::update(const float deltaTime, const std::vector<std::vector<B
     // Water friction
     if (!xBlocked || !yBlocked) {
         if (isInWater) {
-            velocity.y *= 0.8f;
+            velocity.y *= friction;
         }
     }
 
@@ -150,7 +153,7 @@ void EntityPlayer::update(const float deltaTime, const std::vector<std::vector<B
     }
 
     // Friction
-    velocity.x *= 0.8f;
+    velocity.x *= friction;
     if (std::abs(velocity.x) < 0.01f) velocity.x = 0.0f;
 
     ticksLived++;
@@ -163,7 +166,7 @@ bool EntityPlayer::getDirection() const {
     return direction;
 }
 
-uvec2 EntityPlayer::getTargetPosition() const {
+glm::ivec2 EntityPlayer::getTargetPosition() const {
     float placeX = position.x;
     float placeY = position.y;
 
@@ -175,6 +178,6 @@ uvec2 EntityPlayer::getTargetPosition() const {
         placeY += height / 2.0f; // Center vertically
         placeX += (getDirection() ? 1.0f : -1.0f);
     }
-    return {static_cast<int>(floor(placeX)), static_cast<int>(floor(placeY))};
+    return {static_cast<int>(std::floor(placeX)), static_cast<int>(std::floor(placeY))};
 }
 } // arcader
\ No newline at end of file
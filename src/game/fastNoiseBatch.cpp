@@ -0,0 +1,193 @@
+#include "game/fastNoiseBatch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace arcader {
+namespace {
+/**
+ * Settings the vector kernels need, copied out of FastNoiseLite.
+ */
+struct KernelParams {
+    int seed;
+    float frequency;
+    const float *gradients;
+};
+
+constexpr int32_t PrimeX = 501125321;
+constexpr int32_t PrimeY = 1136930381;
+
+#if defined(__GNUC__) // GCC and Clang vector extensions, the compiler maps them to the available SIMD registers
+#pragma GCC diagnostic ignored "-Wpsabi" // helpers are always inlined, their vector ABI never matters
+#define NOISE_INLINE inline __attribute__((always_inline)) // also at -O0, every clone has its own register ABI
+constexpr int LANES = 8;
+typedef float vfloat __attribute__((vector_size(LANES * sizeof(float))));
+typedef int32_t vint __attribute__((vector_size(LANES * sizeof(int32_t))));
+typedef uint32_t vuint __attribute__((vector_size(LANES * sizeof(uint32_t))));
+
+// Build an AVX2 and an SSE4.2 version next to the baseline one, picked once at load time
+#if defined(__x86_64__) && defined(__linux__) && !defined(__clang__)
+#define NOISE_TARGETS __attribute__((target_clones("avx2", "sse4.2", "default")))
+#else
+#define NOISE_TARGETS
+#endif
+
+NOISE_INLINE vfloat load(const float *p) {
+    vfloat v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+NOISE_INLINE void store(float *p, const vfloat v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+NOISE_INLINE vfloat select(const vint mask, const vfloat a, const vfloat b) {
+    return reinterpret_cast<vfloat>((mask & reinterpret_cast<vint>(a)) | (~mask & reinterpret_cast<vint>(b)));
+}
+
+NOISE_INLINE vuint select(const vint mask, const vuint a, const vuint b) {
+    const vuint m = reinterpret_cast<vuint>(mask);
+    return (m & a) | (~m & b);
+}
+
+// Everything below mirrors the scalar FastNoiseLite code operation by operation,
+// so the rounding of every step and therefore the result is exactly the same.
+
+NOISE_INLINE vint fastFloor(const vfloat f) {
+    const vfloat zero = {};
+    return __builtin_convertvector(f, vint) + (f < zero); // mask is -1 for negative values
+}
+
+NOISE_INLINE vfloat interpQuintic(const vfloat t) {
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+NOISE_INLINE vfloat lerp(const vfloat a, const vfloat b, const vfloat t) {
+    return a + t * (b - a);
+}
+
+NOISE_INLINE vfloat gradCoord(const KernelParams &params, const vuint xPrimed, const vuint yPrimed,
+                        const vfloat xd, const vfloat yd) {
+    vuint hash = static_cast<uint32_t>(params.seed) ^ xPrimed ^ yPrimed;
+    hash *= 0x27d4eb2du;
+    vint h = reinterpret_cast<vint>(hash);
+    h ^= h >> 15;
+    h &= 127 << 1;
+
+    vfloat xg, yg;
+    for (int i = 0; i < LANES; ++i) { // no gather before AVX2, the compiler picks the best it can do
+        xg[i] = params.gradients[h[i]];
+        yg[i] = params.gradients[h[i] | 1];
+    }
+    return xd * xg + yd * yg;
+}
+
+NOISE_TARGETS
+void perlinRows(const KernelParams &params, const float *xs, const float *ys, float *out, const size_t count) {
+    for (size_t i = 0; i < count; i += LANES) {
+        const vfloat x = load(xs + i) * params.frequency;
+        const vfloat y = load(ys + i) * params.frequency;
+
+        const vint x0 = fastFloor(x);
+        const vint y0 = fastFloor(y);
+
+        const vfloat xd0 = x - __builtin_convertvector(x0, vfloat);
+        const vfloat yd0 = y - __builtin_convertvector(y0, vfloat);
+        const vfloat xd1 = xd0 - 1;
+        const vfloat yd1 = yd0 - 1;
+
+        const vfloat xs0 = interpQuintic(xd0);
+        const vfloat ys0 = interpQuintic(yd0);
+
+        const vuint x0p = reinterpret_cast<vuint>(x0) * static_cast<uint32_t>(PrimeX);
+        const vuint y0p = reinterpret_cast<vuint>(y0) * static_cast<uint32_t>(PrimeY);
+        const vuint x1p = x0p + static_cast<uint32_t>(PrimeX);
+        const vuint y1p = y0p + static_cast<uint32_t>(PrimeY);
+
+        const vfloat xf0 = lerp(gradCoord(params, x0p, y0p, xd0, yd0), gradCoord(params, x1p, y0p, xd1, yd0), xs0);
+        const vfloat xf1 = lerp(gradCoord(params, x0p, y1p, xd0, yd1), gradCoord(params, x1p, y1p, xd1, yd1), xs0);
+
+        store(out + i, lerp(xf0, xf1, ys0) * 1.4247691104677813f);
+    }
+}
+
+NOISE_TARGETS
+void simplexRows(const KernelParams &params, const float *xs, const float *ys, float *out, const size_t count) {
+    const float SQRT3 = 1.7320508075688772935274463415059f;
+    const float F2 = 0.5f * (SQRT3 - 1);
+    const float G2 = (3 - SQRT3) / 6;
+    const vfloat zero = {};
+
+    for (size_t i = 0; i < count; i += LANES) {
+        // OpenSimplex2 skews the input coordinates before sampling
+        vfloat x = load(xs + i) * params.frequency;
+        vfloat y = load(ys + i) * params.frequency;
+        const vfloat skew = (x + y) * F2;
+        x += skew;
+        y += skew;
+
+        const vint xi = fastFloor(x);
+        const vint yi = fastFloor(y);
+        const vfloat xf = x - __builtin_convertvector(xi, vfloat);
+        const vfloat yf = y - __builtin_convertvector(yi, vfloat);
+
+        const vfloat t = (xf + yf) * G2;
+        const vfloat x0 = xf - t;
+        const vfloat y0 = yf - t;
+
+        const vuint ip = reinterpret_cast<vuint>(xi) * static_cast<uint32_t>(PrimeX);
+        const vuint jp = reinterpret_cast<vuint>(yi) * static_cast<uint32_t>(PrimeY);
+
+        const vfloat a = 0.5f - x0 * x0 - y0 * y0;
+        const vfloat n0 = select(a <= zero, zero, (a * a) * (a * a) * gradCoord(params, ip, jp, x0, y0));
+
+        const vfloat c = static_cast<float>(2 * (1 - 2 * G2) * (1 / G2 - 2)) * t +
+                         (static_cast<float>(-2 * (1 - 2 * G2) * (1 - 2 * G2)) + a);
+        const vfloat x2 = x0 + (2 * G2 - 1);
+        const vfloat y2 = y0 + (2 * G2 - 1);
+        const vfloat n2 = select(c <= zero, zero,
+                                 (c * c) * (c * c) * gradCoord(params, ip + static_cast<uint32_t>(PrimeX),
+                                                               jp + static_cast<uint32_t>(PrimeY), x2, y2));
+
+        // Middle corner depends on the triangle the point is in, both are computed and masked
+        const vint upper = y0 > x0;
+        const vfloat x1 = select(upper, x0 + G2, x0 + (G2 - 1));
+        const vfloat y1 = select(upper, y0 + (G2 - 1), y0 + G2);
+        const vuint i1 = select(upper, ip, ip + static_cast<uint32_t>(PrimeX));
+        const vuint j1 = select(upper, jp + static_cast<uint32_t>(PrimeY), jp);
+        const vfloat b = 0.5f - x1 * x1 - y1 * y1;
+        const vfloat n1 = select(b <= zero, zero, (b * b) * (b * b) * gradCoord(params, i1, j1, x1, y1));
+
+        store(out + i, (n0 + n1 + n2) * 99.83685446303647f);
+    }
+}
+#endif
+} // namespace
+
+void FastNoiseBatch::GetNoise(const FastNoiseLite &noise, const std::span<const float> xs,
+                              const std::span<const float> ys, const std::span<float> out) {
+    const size_t count = std::min({xs.size(), ys.size(), out.size()});
+    size_t done = 0;
+
+#if defined(__GNUC__)
+    if (noise.mFractalType == FastNoiseLite::FractalType_None) {
+        const KernelParams params{noise.mSeed, noise.mFrequency, FastNoiseLite::Lookup<float>::Gradients2D};
+        const size_t vectorCount = count - count % LANES;
+        if (noise.mNoiseType == FastNoiseLite::NoiseType_Perlin) {
+            perlinRows(params, xs.data(), ys.data(), out.data(), vectorCount);
+            done = vectorCount;
+        } else if (noise.mNoiseType == FastNoiseLite::NoiseType_OpenSimplex2) {
+            simplexRows(params, xs.data(), ys.data(), out.data(), vectorCount);
+            done = vectorCount;
+        }
+    }
+#endif
+
+    // Remaining points and unsupported noise settings
+    for (size_t i = done; i < count; ++i) {
+        out[i] = noise.GetNoise(xs[i], ys[i]);
+    }
+}
+} // arcader
@@ -4,42 +4,79 @@
 
 #include "game/gameManager.hpp"
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <random>
+#include <thread>
 
 #include "framework/mesh.hpp"
 #include "game/block.hpp"
 #include "game/FastNoiseLite.hpp"
+#include "profiler.hpp"
 
 namespace arcader {
+namespace {
+/**
+ * Spill file of a column, the revision keeps late writes of a regenerated world from being restored.
+ */
+std::filesystem::path spillFile(const std::filesystem::path &directory, const int chunkX, const uint32_t revision) {
+    return directory / (std::to_string(revision) + "_" + std::to_string(chunkX) + ".chunk");
+}
+} // namespace
+
+GameManager::SpillDirectory::SpillDirectory() {
+    std::random_device random;
+    const uint64_t suffix = static_cast<uint64_t>(random()) << 32 | random();
+    char name[32];
+    snprintf(name, sizeof(name), "arcade_world_%016llx", static_cast<unsigned long long>(suffix));
+    path = std::filesystem::temp_directory_path() / name;
+}
+
+GameManager::SpillDirectory::~SpillDirectory() {
+    std::error_code error;
+    std::filesystem::remove_all(path, error);
+}
 
 GameManager::GameManager(AssetManager *assetsManager, int *height, int *width) : assets(assetsManager), screenHeight(height), screenWidth(width),
                                                                                  tileShader(assetsManager->getShader(StaticAssets::SHADER_TILE)),
                                                                                  entityShader(assetsManager->getShader(StaticAssets::SHADER_ENTITY)),
                                                                                  debugShader(assetsManager->getShader(StaticAssets::SHADER_DEBUG)),
                                                                                  hudShader(assetsManager->getShader(StaticAssets::SHADER_HUD)),
+                                                                                 tileUniforms(assetsManager->getUniforms(StaticAssets::SHADER_TILE)),
+                                                                                 debugUniforms(assetsManager->getUniforms(StaticAssets::SHADER_DEBUG)),
                                                                                  audioPlayer(AudioPlayer{}) {
     audioPlayer.init();
-    blocks.resize(worldWidth, std::vector<Block>(worldHeight));
-};
 
-void GameManager::init() {
-    printf("Initializing game...\n");
-    startTime = static_cast<float>(glfwGetTime()); // Store start time to start from 0
+    // Sampler units never change
+    tileShader.use();
+    tileUniforms.set("u_Texture", 1);
+    tileUniforms.set("u_Atlas", 0);
+};
 
-    // Load textures
-    printf("  - Loading textures...\n");
+void GameManager::preload() {
+    // All sprites are packed into one texture array
+    std::vector<std::pair<StaticAssets, std::filesystem::path>> sprites;
     for (auto type : BlockStates::getBlockTypes()) {
         StaticAssets texture = BlockStates::getTextureToFromType(type);
-        assets->loadTexture(texture, "assets/textures/game/" + BlockStates::getTextureName(type) + ".png");
+        sprites.emplace_back(texture, "assets/textures/game/" + BlockStates::getTextureName(type) + ".png");
     }
-    assets->loadTexture(StaticAssets::PLAYER_IDLE, "assets/textures/game/player_stand.png");
-    assets->loadTexture(StaticAssets::PLAYER_MINE, "assets/textures/game/player_mine.png");
-    assets->loadTexture(StaticAssets::PLAYER_WALK1, "assets/textures/game/player_walk1.png");
-    assets->loadTexture(StaticAssets::PLAYER_WALK2, "assets/textures/game/player_stand.png"); // Reusing stand texture for walk2
-    assets->loadTexture(StaticAssets::PLAYER_WALK3, "assets/textures/game/player_walk2.png");
-    assets->loadTexture(StaticAssets::HUD_SLOT, "assets/textures/game/slot.png");
-    assets->loadTexture(StaticAssets::BACKGROUND, "assets/textures/game/background.png");
+    sprites.emplace_back(StaticAssets::MISSING_TEXTURE, "assets/textures/game/missing_texture.png");
+    sprites.emplace_back(StaticAssets::PLAYER_IDLE, "assets/textures/game/player_stand.png");
+    sprites.emplace_back(StaticAssets::PLAYER_MINE, "assets/textures/game/player_mine.png");
+    sprites.emplace_back(StaticAssets::PLAYER_WALK1, "assets/textures/game/player_walk1.png");
+    sprites.emplace_back(StaticAssets::PLAYER_WALK2, "assets/textures/game/player_stand.png"); // Reusing stand texture for walk2
+    sprites.emplace_back(StaticAssets::PLAYER_WALK3, "assets/textures/game/player_walk2.png");
+    sprites.emplace_back(StaticAssets::HUD_SLOT, "assets/textures/game/slot.png");
+    assets->loadSpriteArrayAsync(sprites);
+    assets->loadTextureAsync(StaticAssets::BACKGROUND, "assets/textures/game/background.png");
+}
+
+void GameManager::init() {
+    printf("Initializing game...\n");
+    startTime = static_cast<float>(glfwGetTime()); // Store start time to start from 0
+    tileRenderer.markDirty(); // sprite layers are looked up again
 
     // Load mesh
     printf("  - Loading mesh...\n");
@@ -58,183 +95,211 @@ void GameManager::init() {
     mesh = Mesh();
     mesh.load(vertices, indices);
 
-    // Initialize blocks (temp, maybe doing procedural generation later)
+    // Initialize blocks
     printf("  - Initializing blocks...\n");
-    std::random_device rd;
-    seed = static_cast<int>(rd());
-    frequency = 0.04f;
-    terrainBase = 0.0f;
-    terrainPeak = 100.0f;
-    treeFrequency = 0.15f;
-    waterLevel = 7;
-    generateTerrain();
-    generateTrees();
+    entities.clear();
+    player = nullptr;
+    if (randomSeed) {
+        std::random_device rd;
+        terrain.seed = static_cast<int>(rd());
+    }
+    terrain.frequency = 0.04f;
+    terrain.terrainBase = 0.0f;
+    terrain.terrainPeak = 100.0f;
+    terrain.treeFrequency = 0.15f;
+    terrain.waterLevel = 7;
+    generateWorld(true);
+    printf("  - Seed %d\n", terrain.seed);
 
     // Initialize player
     printf("  - Initializing entities...\n");
-    entities.clear();
-    auto pPlayer = std::make_unique<EntityPlayer>(vec2(16.5, BlockStates::getHighestBlock(true, 16, blocks) + 1));
+    const int spawnBlock = static_cast<int>(std::floor(spawnX));
+    auto pPlayer = std::make_unique<EntityPlayer>(vec2(spawnX, BlockStates::getHighestBlock(true, spawnBlock, world) + 1));
     player = pPlayer.get();
     entities.push_back(std::move(pPlayer));
 }
 
-void GameManager::generateTerrain() {
-    // Reset
-    for (int x = 0; x < worldWidth; ++x) {
-        for (int y = 0; y < worldHeight; ++y) {
-            blocks[x][y] = {BlockType::AIR, StaticAssets::BLOCK_AIR};
-        }
+void GameManager::generateWorld(const bool blocking) {
+    generator = std::make_shared<const TerrainGenerator>(terrain, worldHeight);
+    ++worldRevision;
+    pendingColumns.clear(); // jobs of the old revision are dropped by the workers
+    blockScheduler.clear();
+    {
+        const std::lock_guard lock(spillMutex);
+        spillingColumns.clear();
     }
 
-    FastNoiseLite noise;
-    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-
-    noise.SetSeed(seed);
-    noise.SetFrequency(frequency);
-
-    for (int x = 0; x < worldWidth; ++x) {
-        // Base terrain height
-        const float base = noise.GetNoise(static_cast<float>(x), terrainBase);                  // Base terrain
-        const float mountain = noise.GetNoise(static_cast<float>(x) * 0.5f, terrainPeak);  // Large features
-
-        // Shape terrain: combine noise layers
-        int height = 8 + static_cast<int>(
-            base * 4.0f +
-            std::pow(std::max(0.0f, mountain), 3.0f) * 25.0f +
-            std::sin(x * 0.3f) * 1.5f
-        );
-        height = std::min(height, worldHeight - 3); // Leave some space for blocks above
-
-        for (int y = 0; y < worldHeight; ++y) {
-            const auto pos = uvec2(x, y);
-            if (y < height - 3)
-                placeBlock(pos, BlockType::STONE);
-            else if (y < height - 1)
-                placeBlock(pos, BlockType::DIRT);
-            else if (y == height - 1)
-                placeBlock(pos, BlockType::GRASS);
-            else if (y <= waterLevel)
-                placeBlock(pos, BlockType::WATER);
-            else
-                blocks[x][y] = {BlockType::AIR, StaticAssets::BLOCK_AIR}; // dont use place function on air, waste of resources
-        }
-    }
-}
+    // Spilled columns belong to the old world
+    std::error_code error;
+    std::filesystem::remove_all(spillDirectory.path, error);
+    std::filesystem::create_directories(spillDirectory.path, error);
 
-void GameManager::generateTrees() {
-    FastNoiseLite treeNoise;
-    treeNoise.SetSeed(seed + 42); // Offset from terrain seed
-    treeNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    treeNoise.SetFrequency(treeFrequency); // Controls tree spacing
-
-    for (int x = 1; x < worldWidth - 1; ++x) {
-        for (int y = 0; y < worldHeight - 4; ++y) {
-            if (blocks[x][y].type != BlockType::GRASS)
-                continue;
-
-            // Check space above for tree
-            bool canPlaceTree = true;
-            for (int dy = 1; dy <= 3 && canPlaceTree; ++dy) {
-                if (blocks[x][y + dy].type != BlockType::AIR)
-                    canPlaceTree = false;
-            }
+    loadChunks(player ? player->position.x : spawnX, blocking);
+}
 
-            if (!canPlaceTree)
-                continue;
+void GameManager::loadChunks(const float centerX, const bool blocking) {
+    const int center = World::toChunk(static_cast<int>(std::floor(centerX)));
+    const uint32_t revision = worldRevision.load();
+    const auto isCurrent = [&](const int chunkX) {
+        return world.isLoaded(chunkX) && world.getRevision(chunkX) == revision;
+    };
 
-            // Use noise to decide whether to place a tree
-            const float noiseValue = treeNoise.GetNoise(static_cast<float>(x), static_cast<float>(y));
-            if (noiseValue < 0.4f) // Density
-                continue;
+    while (true) {
+        // Store finished columns, results of old revisions or out of range are dropped
+        GeneratedColumn column;
+        while (generatedColumns.pop(column)) {
+            std::erase(pendingColumns, std::pair(column.chunkX, column.revision));
+            if (column.revision != revision || std::abs(column.chunkX - center) > loadRadius) continue;
+
+            // Spill the evicted column if it can not be regenerated, its pending updates are dropped
+            const int evicted = world.getSlotOccupant(column.chunkX);
+            if (evicted != World::NO_CHUNK && evicted != column.chunkX) blockScheduler.clearColumn(evicted);
+            if (evicted != World::NO_CHUNK && evicted != column.chunkX &&
+                world.getRevision(evicted) == revision && world.isModified(evicted)) {
+                spillColumn(evicted);
+            }
 
-            std::mt19937 gen(seed + x);
-            std::uniform_real_distribution dist(2.0f, 5.0f);
-            const int treeHeight = static_cast<int>(dist(gen)); // 2 to 5
+            world.loadColumn(column.chunkX, column.blocks.data(), column.revision,
+                             column.levels.empty() ? nullptr : column.levels.data());
+        }
 
-            // Place wood
-            for (int i = 1; i < treeHeight; ++i) {
-                placeBlock(uvec2(x, y + i), BlockType::WOOD);
+        // Request missing columns, nearest first so the ones the player is about to see are ready first
+        bool complete = true;
+        for (int distance = 0; distance <= loadRadius; ++distance) {
+            for (const int chunkX : {center + distance, center - distance}) {
+                if (isCurrent(chunkX)) continue;
+                complete = false;
+                if (std::ranges::find(pendingColumns, std::pair(chunkX, revision)) != pendingColumns.end()) continue;
+
+                pendingColumns.emplace_back(chunkX, revision);
+                workers.submit([this, chunkX, revision, generator = generator,
+                                size = world.getColumnSize(), spillDirectory = spillDirectory.path] {
+                    const auto isStale = [&] { return revision != worldRevision.load(); };
+                    if (isStale()) return; // world was regenerated while this job waited
+                    GeneratedColumn result{chunkX, revision, std::vector<BlockType>(size), std::vector<uint8_t>(size)};
+
+                    // Restore the column from a spill still being written or from disk, otherwise generate it
+                    std::shared_ptr<const SpilledColumn> spilling;
+                    {
+                        const std::lock_guard lock(spillMutex);
+                        const auto it = spillingColumns.find(chunkX);
+                        if (it != spillingColumns.end()) spilling = it->second;
+                    }
+                    if (spilling && spilling->revision == revision) {
+                        result.blocks = spilling->blocks;
+                        result.levels = spilling->levels;
+                    } else {
+                        std::ifstream file(spillFile(spillDirectory, chunkX, revision), std::ios::binary);
+                        if (!file || !file.read(reinterpret_cast<char *>(result.blocks.data()),
+                                                static_cast<std::streamsize>(size)) ||
+                            !file.read(reinterpret_cast<char *>(result.levels.data()),
+                                       static_cast<std::streamsize>(size))) {
+                            generator->generateColumn(chunkX, result.blocks.data());
+                            result.levels.clear(); // water of generated columns is full
+                        }
+                    }
+
+                    while (!generatedColumns.push(std::move(result)) && !isStale()) {
+                        std::this_thread::yield(); // main thread drains the queue every frame
+                    }
+                });
             }
-
-            // Place leaves
-            placeBlock(uvec2(x, y + 1 + treeHeight), BlockType::LEAVES); // center top
-            placeBlock(uvec2(x - 1, y + treeHeight), BlockType::LEAVES);
-            placeBlock(uvec2(x,     y + treeHeight), BlockType::LEAVES);
-            placeBlock(uvec2(x + 1, y + treeHeight), BlockType::LEAVES);
         }
+
+        if (complete || !blocking) return;
+        std::this_thread::yield();
     }
 }
 
-void GameManager::placeBlock(const uvec2 pos, const BlockType type) {
-    const auto x = pos.x;
-    const auto y = pos.y;
-    const auto currentBlock = blocks[x][y];
-    if (type != BlockType::AIR && currentBlock.type == BlockType::WOOD) return;
-
-    const Block newBlock = {type, BlockStates::getTextureToFromType(type)};
-    blocks[x][y] = newBlock;
-
-    // Check if we are grass and need to decay (block above)
-    if (type == BlockType::GRASS) {
-        const auto topBlock = &blocks[x][y+1];
-        if (topBlock->type != BlockType::AIR) blocks[x][y+1] = {BlockType::DIRT, StaticAssets::BLOCK_DIRT};
+void GameManager::spillColumn(const int chunkX) {
+    const size_t size = world.getColumnSize();
+    auto column = std::make_shared<const SpilledColumn>(SpilledColumn{
+        world.getRevision(chunkX),
+        std::vector(world.getColumn(chunkX), world.getColumn(chunkX) + size),
+        std::vector(world.getColumnLevels(chunkX), world.getColumnLevels(chunkX) + size)
+    });
+    {
+        const std::lock_guard lock(spillMutex);
+        spillingColumns[chunkX] = column;
     }
 
-    // Check if we are water and need to flow
-    if (type == BlockType::WATER) {
-        // Check if we can flow down
-        if (y > 0 && blocks[x][y - 1].type == BlockType::AIR) {
-            blockUpdates.push_back({BlockType::WATER, uvec2(x, y - 1)});
-        }
-        // Check if we can flow left or right
-        if (x > 0 && blocks[x - 1][y].type == BlockType::AIR) {
-            blockUpdates.push_back({BlockType::WATER, uvec2(x - 1, y)});
+    workers.submit([this, chunkX, column, spillDirectory = spillDirectory.path] {
+        // Written under a temporary name per thread, so neither a reader nor a concurrent spill of the same
+        // column sees a partial file
+        const std::filesystem::path path = spillFile(spillDirectory, chunkX, column->revision);
+        std::filesystem::path temporary = path;
+        temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary);
+            file.write(reinterpret_cast<const char *>(column->blocks.data()),
+                       static_cast<std::streamsize>(column->blocks.size()));
+            file.write(reinterpret_cast<const char *>(column->levels.data()),
+                       static_cast<std::streamsize>(column->levels.size()));
         }
-        if (x < worldWidth - 1 && blocks[x + 1][y].type == BlockType::AIR) {
-            blockUpdates.push_back({BlockType::WATER, uvec2(x + 1, y)});
+
+        // Only the newest spill of the column is published, an older one finishing later is discarded
+        std::error_code error;
+        const std::lock_guard lock(spillMutex);
+        const auto it = spillingColumns.find(chunkX);
+        if (it == spillingColumns.end() || it->second != column) {
+            std::filesystem::remove(temporary, error);
+            return;
         }
-    }
+        std::filesystem::rename(temporary, path, error);
+        if (error) std::cerr << "Failed to spill chunk column " << chunkX << ": " << error.message() << std::endl;
+        spillingColumns.erase(it);
+    });
+}
 
-    // Check if underneath is grass to decay
-    if (y <= 0) return;
-    const auto subBlock = &blocks[x][y-1];
-    if (subBlock->type == BlockType::GRASS) {
-        blocks[x][y-1] = {BlockType::DIRT, StaticAssets::BLOCK_DIRT};
-    }
+void GameManager::placeBlock(const ivec2 pos, const BlockType type) {
+    const int x = pos.x;
+    const int y = pos.y;
+    if (!world.isInBounds(x, y)) return;
+    const auto currentBlock = world.get(x, y);
+    if (type != BlockType::AIR && currentBlock == BlockType::WOOD) return;
+
+    world.set(x, y, type);
+    blockScheduler.scheduleNeighbourhood(world, pos); // e.g. covered grass decays, water flows
 }
 
-void GameManager::breakBlock(const uvec2 pos) {
-    const auto x = pos.x;
-    const auto y = pos.y;
-    auto [type, texture] = blocks[x][y];
+void GameManager::breakBlock(const ivec2 pos) {
+    const int x = pos.x;
+    const int y = pos.y;
+    if (!world.isInBounds(x, y)) return;
+    const auto type = world.get(x, y);
     if (type == BlockType::AIR || type == BlockType::WATER) return;
     player->selected = type; // Set the selected block type to the one that was broken
-    blocks[x][y] = {BlockType::AIR, StaticAssets::BLOCK_AIR};
-
-    // Update water
-    if ((y < 31 && blocks[x][y + 1].type == BlockType::WATER) || // aboth
-        (x < worldWidth-1 && blocks[x+1][y].type == BlockType::WATER) || // right
-        (x > 0 && blocks[x-1][y].type == BlockType::WATER)) { // left
-        placeBlock(pos, BlockType::WATER);
-    }
+    world.set(x, y, BlockType::AIR);
+    blockScheduler.scheduleNeighbourhood(world, pos); // surrounding water flows into the gap
 }
 
 void GameManager::update(const float deltaTime) {
-    // Update blocks
-    blockUpdateDelay -= deltaTime;
-    if (blockUpdateDelay <= 0.0f) {
-        blockUpdateDelay = 0.1f; // Reset delay
-        const auto updateCopy = blockUpdates;
-        blockUpdates.clear();
-        for (const auto blockUpdate : updateCopy) {
-            placeBlock(blockUpdate.position, blockUpdate.type);
-        }
+    // Advance game ticks, a long hitch only catches up a few ticks
+    tickTimer += deltaTime;
+    for (int i = 0; i < maxTicksPerFrame && tickTimer >= tickLength; ++i) {
+        tickTimer -= tickLength;
+        blockScheduler.advance();
+    }
+    tickTimer = std::min(tickTimer, tickLength);
+
+    // Update due blocks, whatever exceeds the budget stays due and runs first on the next update
+    ivec2 pos;
+    for (int i = 0; i < blockUpdateBudget && blockScheduler.popDue(pos); ++i) {
+        BlockStates::update(world, pos, blockScheduler);
     }
 
+    // Stream in the world around the player
+    loadChunks(player->position.x);
+
     // Update entities
     for (const auto &entity : entities) {
-        entity->update(deltaTime, blocks, audioPlayer);
+        entity->previousPosition = entity->position;
+        entity->update(deltaTime, world, audioPlayer);
     }
+
+    // Collect everything that changed for the consumers of derived data, several steps may run per frame
+    world.drainDirty(dirtyRegions);
+    if (!dirtyRegions.empty()) tileRenderer.markDirty();
 }
 
 void GameManager::renderDebug(Camera& camera) {
@@ -252,27 +317,29 @@ void GameManager::renderDebug(Camera& camera) {
     const mat4 localToWorld = model;
     const mat4 localToClip = projection * view * model;
 
-    debugShader.set("uLocalToClip", localToClip);
-    debugShader.set("uLocalToWorld", localToWorld);
-    debugShader.set("u_Color", vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    debugUniforms.set("uLocalToClip", localToClip);
+    debugUniforms.set("uLocalToWorld", localToWorld);
+    debugUniforms.set("u_Color", vec4(1.0f, 0.0f, 0.0f, 1.0f));
 
     mesh.draw();
 }
 
-void GameManager::render(Camera &camera) {
+void GameManager::render(Camera &camera, const float alpha) {
     const mat4& projection = camera.projectionMatrix;
     const mat4& view = camera.viewMatrix;
 
-    // Camera
+    // Camera follows the player horizontally
     const float relativeWidth = static_cast<float>(*screenWidth) / static_cast<float>(*screenHeight);
-    const float relativeOffset = relativeWidth * worldWidth;
+    const float relativeOffset = relativeWidth * viewWidth;
     camera.projectionMatrix = ortho(
     0.0f, relativeOffset,
     0.0f, static_cast<float>(worldHeight),
     0.1f, 100.0f
     );
 
-    const float offsetX = worldWidth / 2.0f - relativeOffset / 2.0f;
+    const float cameraX = player->getRenderPosition(alpha).x;
+    const float offsetX = cameraX - relativeOffset / 2.0f;
+    const float viewLeft = cameraX - viewWidth / 2.0f; // left edge of the visible screen area
     auto base = vec2(offsetX, 0.0f);
     auto cameraPos   = vec3(base, 10.0f);  // move in XY, look from Z
     auto cameraTarget = vec3(base, 0.0f);   // look straight down at the same XY
@@ -283,110 +350,81 @@ void GameManager::render(Camera &camera) {
         vec3(0.0f, 1.0f, 0.0f) // up direction
     );
     auto time = static_cast<float>(glfwGetTime()) - startTime;
+    retroBuffer.upload({retroShaderData, time});
+
+    // Sprite array on unit 0 stays bound for the whole pass, background uses unit 1
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, assets->getSpriteArray());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, assets->getTexture(StaticAssets::BACKGROUND).handle);
+    glActiveTexture(GL_TEXTURE0);
 
     // --- Render Background ---
-    tileShader.use();
-    mat4 bgModel = translate(mat4(1.0f), vec3(offsetX, 0.0f, 0.0f));
-    bgModel = scale(bgModel, vec3(relativeOffset, worldHeight, 1.0f));
-    mat4 bgMVP = projection * view * bgModel;
+    {
+        const ProfileScope scope("Game Background", true);
+        tileShader.use();
+        mat4 bgModel = translate(mat4(1.0f), vec3(offsetX, 0.0f, 0.0f));
+        bgModel = scale(bgModel, vec3(relativeOffset, worldHeight, 1.0f));
+        mat4 bgMVP = projection * view * bgModel;
 
-    tileShader.set("u_MVP", bgMVP);
-    tileShader.set("u_Time", time);
-    tileShader.set("u_Static", true);
-    tileShader.set("u_Texture", 0);
-    tileShader.set("u_FlipX", false);
+        tileUniforms.set("u_MVP", bgMVP);
+        tileUniforms.set("u_Static", true);
+        tileUniforms.set("u_NoiseFactor", 1.0f);
+        mesh.draw();
+    }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, assets->getTexture(StaticAssets::BACKGROUND).handle);
-    mesh.draw();
-    
     // --- Render Blocks ---
-    tileShader.use();
-    tileShader.set("colorLevels", retroShaderData.colorLevels);
-    tileShader.set("noiseStrength", retroShaderData.noiseStrength);
-    tileShader.set("noiseScale", retroShaderData.noiseScale);
-    tileShader.set("scanlineStrength", retroShaderData.scanlineStrength);
-    tileShader.set("scanlineFrequency", retroShaderData.scanlineFrequency);
-    tileShader.set("u_Texture", 0);
-    tileShader.set("u_Static", false);
-
-    for (int y = 0; y < worldHeight; ++y) {
-        for (int x = 0; x < worldWidth; ++x) {
-            auto& [type, texture] = blocks[x][y];
-            //if (type == BlockType::AIR) continue;
-
-            auto worldPos = vec3(x, y, 0.01f);
-
-            mat4 model = translate(mat4(1.0f), worldPos);
-            mat4 mvp = projection * view * model;
-
-            tileShader.set("u_MVP", mvp);
-            tileShader.set("u_Time", time);
-
-            GLuint texID = assets->getTexture(texture).handle;
-            glBindTexture(GL_TEXTURE_2D, texID);
-            mesh.draw();
+    {
+        const ProfileScope scope("Game Tiles", true);
+        tileUniforms.set("u_Static", false);
+        tileUniforms.set("u_MVP", projection * view);
+
+        if (tileRenderer.isDirty()) tileRenderer.rebuild(world, *assets);
+        tileRenderer.render();
+        dirtyRegions.clear(); // consumed by the upload of this frame
+    }
+
+    // --- Render Entities & HUD ---
+    // All sprites of this frame go into one batch, drawn in ranges that need different uniforms
+    GLsizei hudFirst;
+    {
+        const ProfileScope scope("Game Entities", true);
+        sprites.clear();
+        for (const auto& entity : entities) {
+            auto worldPos = vec3(entity->getRenderPosition(alpha) - vec2(0.75, 0.0), 0.02f);
+            sprites.addQuad(worldPos, vec2(1.5f), assets->getSpriteLayer(entity->getTexture()), entity->getDirection());
+        }
+        hudFirst = sprites.size();
+        sprites.addQuad(vec3(viewLeft + 0.5f, 0.5f, 0.1f), vec2(2.5f), assets->getSpriteLayer(StaticAssets::HUD_SLOT));
+        if (player->selected != BlockType::AIR) {
+            sprites.addQuad(vec3(viewLeft + 1.0f, 1.0f, 0.11f), vec2(1.5f),
+                            assets->getSpriteLayer(BlockStates::getTextureToFromType(player->selected)));
         }
+        sprites.upload();
+
+        sprites.draw(0, hudFirst);
     }
 
-    // --- Render Entities ---
-    for (const auto& entity : entities) {
-        tileShader.use();
-        tileShader.set("u_Texture", 0);
-        tileShader.set("u_FlipX", entity->getDirection());
-
-        auto worldPos = vec3(entity->position - vec2(0.75, 0.0), 0.02f);
-        mat4 model = translate(mat4(1.0f), worldPos);
-        model = scale(model, vec3(1.5f));
-        mat4 mvp = projection * view * model;
-
-        tileShader.set("u_MVP", mvp);
-        tileShader.set("u_Time", time);
-        glBindTexture(GL_TEXTURE_2D, assets->getTexture(entity->getTexture()).handle);
-        //entity->render(mvp, assets);
-        mesh.draw();
+    {
+        const ProfileScope scope("Game HUD", true);
+        tileUniforms.set("u_NoiseFactor", 0.25f); // Less noise on HUD
+        sprites.draw(hudFirst, 1);
+        tileUniforms.set("u_NoiseFactor", 1.0f);
+        sprites.draw(hudFirst + 1, sprites.size() - hudFirst - 1);
+    }
 
-        // ---- Debug ----
-        if (!showHitboxes) continue;
-        debugShader.use();
-        debugShader.set("u_Color", vec4(1.0f, 0.0f, 0.0f, 0.8f));
-        auto worldPos2 = vec3(entity->position - vec2(entity->getWidth() / 2.0f, 0.0), 0.03f);
+    // ---- Debug ----
+    if (!showHitboxes) return;
+    debugShader.use();
+    debugUniforms.set("u_Color", vec4(1.0f, 0.0f, 0.0f, 0.8f));
+    for (const auto& entity : entities) {
+        auto worldPos2 = vec3(entity->getRenderPosition(alpha) - vec2(entity->getWidth() / 2.0f, 0.0), 0.03f);
         mat4 model2 = translate(mat4(1.0f), worldPos2);
         model2 = scale(model2, vec3(entity->getWidth(), entity->getHeight(), 1.0f));
         mat4 mvp2 = projection * view * model2;
-        debugShader.set("u_MVP", mvp2);
+        debugUniforms.set("u_MVP", mvp2);
         mesh.draw();
     }
-
-    // --- Render HUD ---
-    tileShader.use();
-    auto hudPos = vec3(0.5f, 0.5f, 0.1f);
-    mat4 model = translate(mat4(1.0f), hudPos);
-    model = scale(model, vec3(2.5f));
-    mat4 mvp = projection * view * model;
-
-    tileShader.set("noiseStrength", retroShaderData.noiseStrength * 0.25f); // Less noise on HUD
-    tileShader.set("u_MVP", mvp);
-    tileShader.set("u_Time", time);
-    tileShader.set("u_FlipX", false);
-
-    GLuint texID = assets->getTexture(StaticAssets::HUD_SLOT).handle;
-    glBindTexture(GL_TEXTURE_2D, texID);
-    mesh.draw();
-
-    if (player->selected != BlockType::AIR) {
-        hudPos = vec3(1.0f, 1.0f, 0.11f);
-        model = translate(mat4(1.0f), hudPos);
-        model = scale(model, vec3(1.5f));
-        mvp = projection * view * model;
-        tileShader.set("noiseStrength", retroShaderData.noiseStrength);
-        tileShader.set("u_MVP", mvp);
-
-        texID = assets->getTexture(BlockStates::getTextureToFromType(player->selected)).handle;
-        glBindTexture(GL_TEXTURE_2D, texID);
-        mesh.draw();
-    }
-
 }
 
 void GameManager::keyCallback(const Key key, const Action action, const Modifier modifier) {
@@ -410,9 +448,9 @@ void GameManager::keyCallback(const Key key, const Action action, const Modifier
             // Mining
             if (action != Action::PRESS) return;
             const auto target = player->getTargetPosition();
-            if (!BlockStates::isInBounds(target, blocks)) return;
+            if (!BlockStates::isInBounds(target, world)) return;
 
-            const auto targetType = blocks[target.x][target.y].type;
+            const auto targetType = world.get(target.x, target.y);
             if (!BlockStates::isSolid(targetType)) return; // prevent breaking air or water
 
             player->updateTexture(StaticAssets::PLAYER_MINE, 0.5f);
@@ -425,10 +463,10 @@ void GameManager::keyCallback(const Key key, const Action action, const Modifier
             // Placing
             if (action != Action::PRESS) return;
             const auto target = player->getTargetPosition();
-            if (!BlockStates::isInBounds(target, blocks)) return;
+            if (!BlockStates::isInBounds(target, world)) return;
 
             if (player->selected == BlockType::AIR) return;
-            const auto targetType = blocks[target.x][target.y].type;
+            const auto targetType = world.get(target.x, target.y);
             if (BlockStates::isSolid(targetType)) return; // prevent replacing solid blocks
 
             player->updateTexture(StaticAssets::PLAYER_MINE, 0.5f);
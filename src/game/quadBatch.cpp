@@ -0,0 +1,89 @@
+#include "game/quadBatch.hpp"
+
+#include <cstddef>
+
+namespace arcader {
+
+QuadBatch::~QuadBatch() {
+    if (vao == 0) return;
+    glDeleteBuffers(1, &ebo);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+}
+
+void QuadBatch::clear() {
+    vertices.clear();
+}
+
+void QuadBatch::addQuad(const glm::vec3 &position, const glm::vec2 &size, const GLint layer, const bool flipX) {
+    const float u0 = flipX ? 1.0f : 0.0f;
+    const float u1 = flipX ? 0.0f : 1.0f;
+    const auto l = static_cast<float>(layer);
+    vertices.push_back({position, {u0, 0.0f}, l});
+    vertices.push_back({position + glm::vec3(size.x, 0.0f, 0.0f), {u1, 0.0f}, l});
+    vertices.push_back({position + glm::vec3(size.x, size.y, 0.0f), {u1, 1.0f}, l});
+    vertices.push_back({position + glm::vec3(0.0f, size.y, 0.0f), {u0, 1.0f}, l});
+}
+
+void QuadBatch::initBuffers() {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QuadVertex),
+                          reinterpret_cast<void *>(offsetof(QuadVertex, position)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(QuadVertex),
+                          reinterpret_cast<void *>(offsetof(QuadVertex, texCoord)));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(QuadVertex),
+                          reinterpret_cast<void *>(offsetof(QuadVertex, layer)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); // Element buffer binding is part of the VAO state
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void QuadBatch::upload() {
+    if (vao == 0) initBuffers();
+    const GLsizei quads = size();
+
+    glBindVertexArray(vao);
+
+    // Indices follow a fixed pattern, so they only change when the batch grows
+    if (quads > indexCapacity) {
+        std::vector<GLuint> indices;
+        indices.reserve(static_cast<size_t>(quads) * 6);
+        for (GLuint i = 0; i < static_cast<GLuint>(quads); ++i) {
+            const GLuint base = i * 4;
+            indices.insert(indices.end(), {base, base + 1, base + 2, base + 2, base + 3, base});
+        }
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(GLuint)),
+                     indices.data(), GL_STATIC_DRAW);
+        indexCapacity = quads;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    const auto bytes = static_cast<GLsizeiptr>(vertices.size() * sizeof(QuadVertex));
+    if (quads > vertexCapacity) {
+        glBufferData(GL_ARRAY_BUFFER, bytes, vertices.data(), GL_DYNAMIC_DRAW);
+        vertexCapacity = quads;
+    } else if (bytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    uploadedQuads = quads;
+}
+
+void QuadBatch::draw(const GLsizei first, const GLsizei count) const {
+    if (vao == 0 || count <= 0) return;
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT,
+                   reinterpret_cast<void *>(static_cast<size_t>(first) * 6 * sizeof(GLuint)));
+    glBindVertexArray(0);
+}
+} // arcader
@@ -0,0 +1,157 @@
+#include "game/terrainGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "game/fastNoiseBatch.hpp"
+#include "game/world.hpp"
+#include "random.hpp"
+
+namespace arcader {
+namespace {
+/**
+ * Sine built from basic double operations only, std::sin is not guaranteed to round the same on every platform.
+ * The result is rounded to float once at the end.
+ */
+float portableSin(const float x) {
+    constexpr double PI = 3.14159265358979323846;
+    double r = x - 2.0 * PI * std::floor(x / (2.0 * PI) + 0.5); // [-pi, pi]
+    if (r > PI / 2) r = PI - r;
+    else if (r < -PI / 2) r = -PI - r;
+    const double r2 = r * r;
+    // Taylor series up to x^11, error below 1e-7 on [-pi/2, pi/2]
+    const double series = 1.0 - r2 / 6.0 * (1.0 - r2 / 20.0 * (1.0 - r2 / 42.0 * (1.0 - r2 / 72.0 * (1.0 - r2 / 110.0))));
+    return static_cast<float>(r * series);
+}
+} // namespace
+
+TerrainGenerator::TerrainGenerator(const TerrainSettings &settings, const int worldHeight) :
+    settings(settings),
+    worldHeight(worldHeight) {
+    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    noise.SetSeed(settings.seed);
+    noise.SetFrequency(settings.frequency);
+
+    treeNoise.SetSeed(settings.seed + 42); // Offset from terrain seed
+    treeNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    treeNoise.SetFrequency(settings.treeFrequency); // Controls tree spacing
+}
+
+void TerrainGenerator::getTerrainHeights(const int x0, int *heights) const {
+    float xs[ROW_SIZE], mountainXs[ROW_SIZE], baseYs[ROW_SIZE], peakYs[ROW_SIZE];
+    for (int i = 0; i < ROW_SIZE; ++i) {
+        xs[i] = static_cast<float>(x0 + i);
+        mountainXs[i] = xs[i] * 0.5f;
+        baseYs[i] = settings.terrainBase;
+        peakYs[i] = settings.terrainPeak;
+    }
+
+    float base[ROW_SIZE], mountain[ROW_SIZE];
+    FastNoiseBatch::GetNoise(noise, xs, baseYs, base);                // Base terrain
+    FastNoiseBatch::GetNoise(noise, mountainXs, peakYs, mountain);    // Large features
+
+    for (int i = 0; i < ROW_SIZE; ++i) {
+        const int x = x0 + i;
+        // Shape terrain: combine noise layers
+        const float peak = std::max(0.0f, mountain[i]);
+        const int height = 8 + static_cast<int>(
+            base[i] * 4.0f +
+            peak * peak * peak * 25.0f +
+            portableSin(x * 0.3f) * 1.5f
+        );
+        heights[i] = std::min(height, worldHeight - 3); // Leave some space for blocks above
+    }
+}
+
+void TerrainGenerator::getTreeHeights(const int x0, const int *terrainHeights, int *treeHeights) const {
+    // Trees grow on top of the terrain, sample the noise there for the whole row at once
+    float xs[ROW_SIZE], ys[ROW_SIZE], noiseValues[ROW_SIZE];
+    for (int i = 0; i < ROW_SIZE; ++i) {
+        xs[i] = static_cast<float>(x0 + i);
+        ys[i] = static_cast<float>(terrainHeights[i] - 1);
+    }
+    FastNoiseBatch::GetNoise(treeNoise, xs, ys, noiseValues);
+
+    for (int i = 0; i < ROW_SIZE; ++i) {
+        treeHeights[i] = 0;
+        // Trees only grow on grass, which is turned into dirt when covered by water
+        const int y = terrainHeights[i] - 1;
+        if (terrainHeights[i] <= settings.waterLevel || y < 0 || y >= worldHeight - 4)
+            continue;
+        if (noiseValues[i] < 0.4f) // Density
+            continue;
+
+        Random random(Random::hash(settings.seed, x0 + i));
+        treeHeights[i] = static_cast<int>(random.nextFloat(2.0f, 5.0f)); // 2 to 4
+    }
+}
+
+void TerrainGenerator::generateColumn(const int chunkX, BlockType *out) const {
+    constexpr int size = World::CHUNK_SIZE;
+    const int x0 = chunkX * size;
+    const auto at = [&](const int localX, const int y) -> BlockType & { return out[y * size + localX]; };
+
+    // Terrain, one extra column on each side for the trees at the chunk borders
+    static_assert(ROW_SIZE == size + 2);
+    int heights[ROW_SIZE];
+    getTerrainHeights(x0 - 1, heights);
+
+    for (int lx = 0; lx < size; ++lx) {
+        const int height = heights[lx + 1];
+        for (int y = 0; y < worldHeight; ++y) {
+            if (y < height - 3)
+                at(lx, y) = BlockType::STONE;
+            else if (y < height - 1)
+                at(lx, y) = BlockType::DIRT;
+            else if (y == height - 1)
+                at(lx, y) = height <= settings.waterLevel ? BlockType::DIRT : BlockType::GRASS; // grass decays under water
+            else if (y <= settings.waterLevel)
+                at(lx, y) = BlockType::WATER;
+            else
+                at(lx, y) = BlockType::AIR;
+        }
+    }
+
+    // Trees, including the ones rooted in a neighbour column whose leaves reach into this one
+    const auto placeTreeBlock = [&](const int x, const int y, const BlockType type) {
+        const int lx = x - x0;
+        if (lx < 0 || lx >= size || y < 0 || y >= worldHeight) return;
+        if (at(lx, y) == BlockType::WOOD) return; // never overwrite trunks
+        at(lx, y) = type;
+        if (y > 0 && at(lx, y - 1) == BlockType::GRASS) at(lx, y - 1) = BlockType::DIRT;
+    };
+
+    int treeHeights[ROW_SIZE];
+    getTreeHeights(x0 - 1, heights, treeHeights);
+    for (int i = 0; i < ROW_SIZE; ++i) {
+        const int x = x0 - 1 + i;
+        const int treeHeight = treeHeights[i];
+        if (treeHeight == 0) continue;
+        const int y = heights[i] - 1;
+
+        // Place wood
+        for (int j = 1; j < treeHeight; ++j) {
+            placeTreeBlock(x, y + j, BlockType::WOOD);
+        }
+
+        // Place leaves
+        placeTreeBlock(x, y + 1 + treeHeight, BlockType::LEAVES); // center top
+        placeTreeBlock(x - 1, y + treeHeight, BlockType::LEAVES);
+        placeTreeBlock(x,     y + treeHeight, BlockType::LEAVES);
+        placeTreeBlock(x + 1, y + treeHeight, BlockType::LEAVES);
+    }
+}
+
+uint64_t TerrainGenerator::hashColumns(const int firstChunkX, const int count) const {
+    std::vector<BlockType> blocks(static_cast<size_t>(World::CHUNK_SIZE) * worldHeight);
+    uint64_t hash = 0xcbf29ce484222325ull; // FNV-1a
+    for (int chunkX = firstChunkX; chunkX < firstChunkX + count; ++chunkX) {
+        generateColumn(chunkX, blocks.data());
+        for (const BlockType type : blocks) {
+            hash = (hash ^ static_cast<uint8_t>(type)) * 0x100000001b3ull;
+        }
+    }
+    return hash;
+}
+} // arcader
@@ -0,0 +1,37 @@
+#include "game/tileRenderer.hpp"
+
+#include <array>
+
+namespace arcader {
+
+void TileRenderer::rebuild(const World &world, const AssetManager &assets) {
+    std::array<GLint, BLOCK_TYPE_COUNT> layers{};
+    for (const auto type : BlockStates::getBlockTypes()) {
+        layers[static_cast<size_t>(type)] = assets.getSpriteLayer(BlockStates::getTextureToFromType(type));
+    }
+
+    batch.clear();
+    for (int slot = 0; slot < world.getColumnCapacity(); ++slot) {
+        const int chunkX = world.getLoadedChunk(slot);
+        if (chunkX == World::NO_CHUNK) continue;
+
+        const BlockType *column = world.getColumn(chunkX);
+        const uint8_t *levels = world.getColumnLevels(chunkX);
+        const int x0 = chunkX * World::CHUNK_SIZE;
+        for (int y = 0; y < world.getHeight(); ++y) {
+            for (int lx = 0; lx < World::CHUNK_SIZE; ++lx) {
+                const int i = y * World::CHUNK_SIZE + lx;
+                const GLint layer = layers[static_cast<size_t>(column[i])];
+                // Water is only drawn as high as it is filled
+                const float height = column[i] == BlockType::WATER
+                                         ? static_cast<float>(levels[i]) / World::FULL_LEVEL
+                                         : 1.0f;
+                batch.addQuad(glm::vec3(x0 + lx, y, 0.01f), glm::vec2(1.0f, height), layer);
+            }
+        }
+    }
+
+    batch.upload();
+    dirty = false;
+}
+} // arcader
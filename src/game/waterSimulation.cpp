@@ -0,0 +1,51 @@
+#include "game/waterSimulation.hpp"
+
+#include <algorithm>
+
+namespace arcader {
+
+void WaterSimulation::update(World &world, const glm::ivec2 pos, BlockScheduler &scheduler) {
+    const int x = pos.x;
+    const int y = pos.y;
+    if (!world.isInBounds(x, y) || world.get(x, y) != BlockType::WATER) return;
+    int level = world.getLevel(x, y);
+
+    const auto canHold = [&](const int cx, const int cy) {
+        if (!world.isInBounds(cx, cy)) return false;
+        const BlockType type = world.get(cx, cy);
+        return type == BlockType::AIR || (type == BlockType::WATER && world.getLevel(cx, cy) < World::FULL_LEVEL);
+    };
+
+    // Fall into the cell below as far as it has room
+    if (canHold(x, y - 1)) {
+        const int amount = std::min(level, World::FULL_LEVEL - world.getLevel(x, y - 1));
+        transfer(world, pos, {x, y - 1}, static_cast<uint8_t>(amount), scheduler);
+        level -= amount;
+    }
+
+    // Spread one level at a time to lower neighbours, a single level can not be split any further.
+    // The side that is filled first alternates every tick, otherwise water drifts in one direction.
+    const int side = scheduler.getTick() & 1 ? 1 : -1;
+    for (const int dx : {side, -side}) {
+        if (level < 2) break;
+        if (canHold(x + dx, y) && world.getLevel(x + dx, y) <= level - 2) {
+            transfer(world, pos, {x + dx, y}, 1, scheduler);
+            --level;
+        }
+    }
+}
+
+void WaterSimulation::transfer(World &world, const glm::ivec2 from, const glm::ivec2 to, const uint8_t amount,
+                               BlockScheduler &scheduler) {
+    const auto remaining = static_cast<uint8_t>(world.getLevel(from.x, from.y) - amount);
+    if (remaining == 0) world.set(from.x, from.y, BlockType::AIR);
+    else world.setLevel(from.x, from.y, remaining);
+
+    const uint8_t target = world.get(to.x, to.y) == BlockType::WATER ? world.getLevel(to.x, to.y) : 0;
+    world.set(to.x, to.y, BlockType::WATER);
+    world.setLevel(to.x, to.y, static_cast<uint8_t>(target + amount));
+
+    scheduler.scheduleNeighbourhood(world, from);
+    scheduler.scheduleNeighbourhood(world, to);
+}
+} // arcader
@@ -0,0 +1,52 @@
+#include "game/world.hpp"
+
+namespace arcader {
+namespace {
+constexpr DirtyRegion CLEAN_REGION{World::NO_CHUNK, INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+}
+
+World::World(const int height, const int columnCapacity) :
+    height(height),
+    blocks(static_cast<size_t>(columnCapacity) * CHUNK_SIZE * height, BlockType::AIR),
+    levels(blocks.size(), 0),
+    slotChunks(columnCapacity, NO_CHUNK),
+    slotModified(columnCapacity, false),
+    slotRevisions(columnCapacity, 0),
+    slotDirty(columnCapacity, CLEAN_REGION) {
+}
+
+void World::loadColumn(const int chunkX, const BlockType *data, const uint32_t revision, const uint8_t *fluidLevels) {
+    const int slot = slotOf(chunkX);
+    const size_t offset = static_cast<size_t>(slot) * getColumnSize();
+    std::copy_n(data, getColumnSize(), &blocks[offset]);
+    if (fluidLevels) {
+        std::copy_n(fluidLevels, getColumnSize(), &levels[offset]);
+    } else {
+        std::transform(data, data + getColumnSize(), &levels[offset], [](const BlockType type) {
+            return type == BlockType::WATER ? FULL_LEVEL : uint8_t{0};
+        });
+    }
+    slotChunks[slot] = chunkX;
+    slotModified[slot] = false;
+    slotRevisions[slot] = revision;
+    markDirty(slot, 0, 0, CHUNK_MASK, height - 1);
+}
+
+void World::clear() {
+    std::fill(slotChunks.begin(), slotChunks.end(), NO_CHUNK);
+    std::fill(slotModified.begin(), slotModified.end(), false);
+    std::fill(slotDirty.begin(), slotDirty.end(), CLEAN_REGION);
+}
+
+void World::drainDirty(std::vector<DirtyRegion> &out) {
+    for (int slot = 0; slot < getColumnCapacity(); ++slot) {
+        DirtyRegion &region = slotDirty[slot];
+        if (region.minX > region.maxX) continue;
+        if (const int chunkX = slotChunks[slot]; chunkX != NO_CHUNK) {
+            const int x0 = chunkX * CHUNK_SIZE;
+            out.push_back({chunkX, x0 + region.minX, region.minY, x0 + region.maxX, region.maxY});
+        }
+        region = CLEAN_REGION;
+    }
+}
+} // arcader
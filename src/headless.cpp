@@ -0,0 +1,195 @@
+// Headless benchmark of the game simulation.
+// Runs terrain generation, the block scheduler with water and the player physics with scripted input
+// for a number of fixed steps, without window, GL context or audio device.
+// Usage: arcade_bench [steps] [seed]
+//        arcade_bench --verify   checks the generated terrain of fixed seeds against golden hashes
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "audioPlayer.hpp"
+#include "game/blockScheduler.hpp"
+#include "game/entity.hpp"
+#include "game/terrainGenerator.hpp"
+#include "game/world.hpp"
+
+using namespace arcader;
+
+// Count every heap allocation of the process
+static std::atomic<size_t> allocations{0};
+
+void *operator new(const size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int worldHeight = 32;
+constexpr int loadRadius = 3;
+constexpr float simulationStep = 1.0f / 120.0f;
+constexpr float tickLength = 0.05f;
+constexpr int blockUpdateBudget = 4096;
+
+// TerrainGenerator::hashColumns(GOLDEN_FIRST_CHUNK, GOLDEN_CHUNKS) with the game's terrain settings.
+// Generation has to reproduce them on every platform and compiler, only update them for intended terrain changes.
+constexpr int GOLDEN_FIRST_CHUNK = -8;
+constexpr int GOLDEN_CHUNKS = 16;
+
+struct GoldenHash {
+    int seed;
+    uint64_t hash;
+};
+
+constexpr GoldenHash goldenHashes[] = {
+    {1, 0x2bc6223428a3ae9full},
+    {42, 0x43165f8187e5f8ddull},
+    {1337, 0xfb7dfb8c0e3ef2ffull},
+    {-7, 0xb847d9b9c9a33397ull},
+    {2024, 0x25dd367a8a952711ull},
+    {65535, 0x40cb9ebab4f023fdull},
+    {123456789, 0xff0ddf8289dd9c32ull},
+    {-2000000000, 0xc08f0160d6614fd8ull},
+};
+
+struct Stats {
+    size_t columns = 0;
+    double generationSeconds = 0.0;
+    size_t blockUpdates = 0;
+};
+
+/**
+ * Terrain settings of GameManager::init with the given seed.
+ */
+TerrainSettings gameTerrain(const int seed) {
+    TerrainSettings terrain;
+    terrain.seed = seed;
+    terrain.frequency = 0.04f;
+    terrain.terrainBase = 0.0f;
+    terrain.terrainPeak = 100.0f;
+    terrain.treeFrequency = 0.15f;
+    terrain.waterLevel = 7;
+    return terrain;
+}
+
+/**
+ * Compare the generated terrain of every golden seed with its hash.
+ * @return Process exit code, 0 if all hashes match
+ */
+int verify() {
+    int failures = 0;
+    for (const auto &[seed, expected] : goldenHashes) {
+        const TerrainGenerator generator(gameTerrain(seed), worldHeight);
+        const uint64_t hash = generator.hashColumns(GOLDEN_FIRST_CHUNK, GOLDEN_CHUNKS);
+        const bool match = hash == expected;
+        if (!match) ++failures;
+        printf("seed %11d: %016llx %s\n", seed, static_cast<unsigned long long>(hash),
+               match ? "ok" : "MISMATCH");
+    }
+    printf("%d of %zu seeds differ\n", failures, std::size(goldenHashes));
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Generate all missing columns around a position synchronously, like GameManager::loadChunks with blocking.
+ */
+void loadChunks(World &world, const TerrainGenerator &generator, std::vector<BlockType> &buffer, const float centerX,
+                Stats &stats) {
+    const int center = World::toChunk(static_cast<int>(std::floor(centerX)));
+    for (int chunkX = center - loadRadius; chunkX <= center + loadRadius; ++chunkX) {
+        if (world.isLoaded(chunkX)) continue;
+        const auto start = Clock::now();
+        generator.generateColumn(chunkX, buffer.data());
+        world.loadColumn(chunkX, buffer.data());
+        stats.generationSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+        ++stats.columns;
+    }
+}
+
+/**
+ * Scripted input: walk right, sprint every other 5 seconds, jump regularly, dig into the target block
+ * and pour water above the player's head to keep the scheduler busy.
+ */
+void script(const int step, EntityPlayer &player, World &world, BlockScheduler &scheduler) {
+    player.isPressingRight = true;
+    player.isSprinting = step / 600 % 2 == 1;
+    player.isJumping = step % 90 < 5;
+    player.isPressingDown = step % 240 >= 120;
+
+    const glm::ivec2 target = player.getTargetPosition();
+    if (step % 30 == 0 && world.isInBounds(target.x, target.y) && BlockStates::isSolid(world.get(target.x, target.y))) {
+        world.set(target.x, target.y, BlockType::AIR);
+        scheduler.scheduleNeighbourhood(world, target);
+    }
+
+    const glm::ivec2 pour(static_cast<int>(std::floor(player.position.x)), static_cast<int>(player.position.y) + 3);
+    if (step % 120 == 0 && world.isInBounds(pour.x, pour.y) && world.get(pour.x, pour.y) == BlockType::AIR) {
+        world.set(pour.x, pour.y, BlockType::WATER);
+        scheduler.scheduleNeighbourhood(world, pour);
+    }
+}
+} // namespace
+
+int main(const int argc, char **argv) {
+    if (argc > 1 && std::string_view(argv[1]) == "--verify") return verify();
+    const int steps = argc > 1 ? std::stoi(argv[1]) : 120 * 60;
+    const TerrainSettings terrain = gameTerrain(argc > 2 ? std::stoi(argv[2]) : 1337);
+
+    const TerrainGenerator generator(terrain, worldHeight);
+    World world(worldHeight, 2 * loadRadius + 1);
+    BlockScheduler scheduler;
+    AudioPlayer audioPlayer; // never initialized, sounds are skipped
+    std::vector<BlockType> buffer(world.getColumnSize());
+    Stats stats;
+
+    constexpr float spawnX = 16.5f;
+    loadChunks(world, generator, buffer, spawnX, stats);
+    EntityPlayer player(glm::vec2(spawnX, BlockStates::getHighestBlock(true, static_cast<int>(spawnX), world) + 1));
+
+    const size_t allocationsBefore = allocations.load();
+    const auto start = Clock::now();
+    float tickTimer = 0.0f;
+    for (int step = 0; step < steps; ++step) {
+        script(step, player, world, scheduler);
+
+        tickTimer += simulationStep;
+        if (tickTimer >= tickLength) {
+            tickTimer -= tickLength;
+            scheduler.advance();
+        }
+        glm::ivec2 pos;
+        for (int i = 0; i < blockUpdateBudget && scheduler.popDue(pos); ++i) {
+            BlockStates::update(world, pos, scheduler);
+            ++stats.blockUpdates;
+        }
+
+        loadChunks(world, generator, buffer, player.position.x, stats);
+        player.previousPosition = player.position;
+        player.update(simulationStep, world, audioPlayer);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const size_t allocated = allocations.load() - allocationsBefore;
+
+    printf("steps:          %d (%.1f s simulated)\n", steps, steps * simulationStep);
+    printf("wall time:      %.3f s, %.0f steps/s\n", seconds, steps / seconds);
+    printf("columns:        %zu generated, %.3f ms each\n", stats.columns,
+           stats.columns ? stats.generationSeconds * 1000.0 / static_cast<double>(stats.columns) : 0.0);
+    printf("block updates:  %zu, %zu pending\n", stats.blockUpdates, scheduler.getPendingCount());
+    printf("allocations:    %zu (%.2f per step)\n", allocated, static_cast<double>(allocated) / steps);
+    printf("player:         (%.2f, %.2f)\n", player.position.x, player.position.y);
+    return 0;
+}
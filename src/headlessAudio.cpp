@@ -0,0 +1,17 @@
+// Silent AudioPlayer backend for the headless benchmark, linked instead of audioPlayer.cpp so no audio library
+// or device is needed. init never opens a device, so every sound is skipped.
+#include "audioPlayer.hpp"
+
+struct AudioPlayer::Device {};
+
+AudioPlayer::AudioPlayer() = default;
+
+AudioPlayer::~AudioPlayer() = default;
+
+void AudioPlayer::init() {}
+
+void AudioPlayer::play(const std::string &, float) {}
+
+void AudioPlayer::stop(const std::string &) {}
+
+bool AudioPlayer::isPlaying(const std::string &) const { return false; }
@@ -5,6 +5,8 @@
 // Implementation of LightingSystem class
 #include "lightingSystem.hpp"
 
+#include <algorithm>
+
 using namespace arcader;
 
 void LightingSystem::init(const glm::vec3& ambientColor, const glm::vec3& lightDir, const glm::vec3& lightColor) {
@@ -18,11 +20,25 @@ void LightingSystem::update(const glm::vec3& newDir, const glm::vec3& newColor)
     this->lightColor = newColor;
 }
 
-void LightingSystem::bindToShader(Program& shader) const {
-    // Bind ambient light and directional light to the shader
-    shader.set("uAmbientColor", ambientColor);
-    shader.set("uLightDirection", lightDirection);
-    shader.set("uLightColor", lightColor);
+void LightingSystem::upload(const ShadowCascades& cascades) {
+    Block block{};
+    std::copy(std::begin(cascades.lightSpaceMatrices), std::end(cascades.lightSpaceMatrices),
+              block.lightSpaceMatrices);
+    block.cascadeSplits = cascades.splits;
+    block.ambientColor = ambientColor;
+    block.lightDirection = lightDirection;
+    block.lightColor = lightColor;
+
+    // Lights beyond the shader's array are dropped instead of indexing out of bounds
+    block.numPointLights = static_cast<int>(std::min<size_t>(pointLights.size(), MAX_POINT_LIGHTS));
+    for (int i = 0; i < block.numPointLights; ++i) {
+        const auto& light = pointLights[i];
+        block.pointLights[i].position = light.position;
+        block.pointLights[i].color = light.color;
+        block.pointLights[i].intensity = light.intensity;
+        block.pointLights[i].radius = light.radius;
+    }
+    buffer.upload(block);
 }
 
 void LightingSystem::addPointLight(const glm::vec3& position, const glm::vec3& color, float intensity, float radius) {
@@ -33,19 +49,6 @@ const std::vector<LightingSystem::PointLight>& LightingSystem::getPointLights()
     return pointLights;
 }
 
-void LightingSystem::bindPointLightsToShader(Program& shader) const {
-    // Bind point lights to the shader
-    shader.set("uNumPointLights", static_cast<int>(pointLights.size()));
-    for (size_t i = 0; i < pointLights.size(); ++i) {
-        const auto& light = pointLights[i];
-        std::string index = std::to_string(i);
-        shader.set("uPointLights[" + index + "].position", light.position);
-        shader.set("uPointLights[" + index + "].color", light.color);
-        shader.set("uPointLights[" + index + "].intensity", light.intensity);
-        shader.set("uPointLights[" + index + "].radius", light.radius);
-    }
-}
-
 void LightingSystem::clearPointLights() {
     pointLights.clear();
 }
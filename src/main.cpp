@@ -3,7 +3,14 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
 #include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 
 #include "game/gameManager.hpp"
 using namespace glm;
@@ -14,6 +21,10 @@ using namespace glm;
 #include <iostream>
 
 #include "cinematicEngine.hpp"
+#include "cookedMesh.hpp"
+#include "cookedTexture.hpp"
+#include "profiler.hpp"
+#include "programCache.hpp"
 using namespace arcader;
 
 struct MainApp final : App {
@@ -22,7 +33,17 @@ private:
     GameManager gameManager{&assetManager, &screenHeight, &screenWidth};
     CinematicEngine cinematicEngine{&assetManager, &gameManager};
 
+    static constexpr double simulationStep = 1.0 / 120.0; // seconds, gameplay does not depend on the frame rate
+    static constexpr int maxStepsPerFrame = 8;            // caps catching up after a hitch
+    static constexpr double loadingBudgetMs = 8.0;        // render thread time per frame for asset uploads
+    double lastTime = 0.0;
+    double accumulator = 0.0;
+    bool showProfiler = false;
+    bool loading = true; // preloaded assets are still being loaded
+    double pendingTraceSeconds = 0.0; // trace requested on the command line, captured once loading is done
+
 public:
+    static constexpr double defaultTraceSeconds = 5.0;
     int screenWidth = 1920;
     int screenHeight = 1080;
 
@@ -51,6 +72,24 @@ public:
         //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); // Debugging
 
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // better decide between black (uncolored) squares and bg
+
+        // Assets load in the background, the scenes start once everything is there
+        cinematicEngine.preload();
+        gameManager.preload();
+    }
+
+    /**
+     * Capture the next frames to trace.json, open it in chrome://tracing or ui.perfetto.dev
+     */
+    static void startTrace(const double seconds) {
+        Profiler::get().startTrace("trace.json", seconds);
+    }
+
+    /**
+     * Capture a trace as soon as the assets are loaded, so it covers the scenes instead of the loading screen.
+     */
+    void startTraceAfterLoading(const double seconds) {
+        pendingTraceSeconds = seconds;
     }
 
     void changeState(const int offset) {
@@ -68,6 +107,11 @@ public:
      * @param modifier modifier keys (shift, ctrl, alt)
      */
     void keyCallback(const Key key, const Action action, const Modifier modifier) override {
+        if (loading) {
+            if (action == Action::PRESS && key == Key::ESC) close();
+            return;
+        }
+
         if (action == Action::PRESS) {
             switch (key) {
                 case Key::ESC: close();
@@ -78,6 +122,8 @@ public:
                     break;
                 case Key::LEFT: changeState(-1);
                     break;
+                case Key::T: startTrace(defaultTraceSeconds);
+                    break;
                 default: break;
             }
         }
@@ -91,19 +137,65 @@ public:
     }
 
     void render() override {
+        Profiler::get().beginFrame(cinematicEngine.getState());
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // Ladebildschirm, bis alle Assets hochgeladen sind
+        if (loading) {
+            loading = !assetManager.updateLoading(loadingBudgetMs);
+            if (!loading) {
+                ProgramCache::get().printReport();
+                if (pendingTraceSeconds > 0.0) startTrace(std::exchange(pendingTraceSeconds, 0.0));
+            }
+            renderLoadingBar(assetManager.getLoadingProgress());
+            lastTime = glfwGetTime(); // the simulation starts once loading is done
+            return;
+        }
+
+        // Geänderte Shader neu laden
+        ProgramCache::get().reloadChanged();
+
         // Zeit berechnen
-        static float lastTime = 0.0f;
-        const auto currentTime = static_cast<float>(glfwGetTime());
-        const float deltaTime = currentTime - lastTime;
+        const double currentTime = glfwGetTime();
+        accumulator += currentTime - lastTime;
         lastTime = currentTime;
 
-        // Update manuell aufrufen
-        cinematicEngine.update(deltaTime);
+        // Simulation in festen Schritten, nach einem Hänger wird der Rest verworfen
+        int steps = 0;
+        while (accumulator >= simulationStep && steps < maxStepsPerFrame) {
+            cinematicEngine.update(static_cast<float>(simulationStep));
+            accumulator -= simulationStep;
+            ++steps;
+        }
+        if (steps == maxStepsPerFrame) accumulator = std::min(accumulator, simulationStep);
+
+        // Danach rendern, zwischen den letzten beiden Schritten interpoliert
+        cinematicEngine.render(static_cast<float>(accumulator / simulationStep));
+    }
+
+    /**
+     * Draw a progress bar in the middle of the screen with scissored clears, no assets needed.
+     * @param progress loaded fraction
+     */
+    void renderLoadingBar(const float progress) const {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        const int width = viewport[2] / 3;
+        const int height = std::max(viewport[3] / 60, 4);
+        const int x = viewport[0] + (viewport[2] - width) / 2;
+        const int y = viewport[1] + (viewport[3] - height) / 2;
 
-        // Danach rendern
-        cinematicEngine.render();
+        GLfloat clearColor[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(x, y, width, height);
+        glClearColor(0.25f, 0.25f, 0.25f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glScissor(x, y, static_cast<int>(static_cast<float>(width) * progress), height);
+        glClearColor(0.9f, 0.75f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDisable(GL_SCISSOR_TEST);
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
     }
 
     void buildImGui() override {
@@ -122,37 +214,44 @@ public:
         if (ImGui::Button("Previous State")) {
             changeState(-1);
         }
+        ImGui::Checkbox("Profiler", &showProfiler);
+        ImGui::BeginDisabled(Profiler::get().isTracing());
+        if (ImGui::Button("Capture Trace")) startTrace(defaultTraceSeconds);
+        ImGui::EndDisabled();
         ImGui::End();
 
+        if (showProfiler) Profiler::get().buildImGui();
+
         if (gameManager.getPlayer()) {
             // Only show when game is initialized
             ImGui::Begin("Game Management", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
             if (ImGui::Button("Seed Randomize")) {
                 std::random_device rd;
-                gameManager.seed = static_cast<int>(rd());
-                gameManager.generateTerrain();
-                gameManager.generateTrees();
+                gameManager.terrain.seed = static_cast<int>(rd());
+                gameManager.generateWorld();
             }
-            if (ImGui::SliderFloat("Frequency", &gameManager.frequency, 0.01f, 0.1f)) {
-                gameManager.generateTerrain();
-                gameManager.generateTrees();
+            if (ImGui::InputInt("Seed", &gameManager.terrain.seed)) {
+                gameManager.generateWorld();
             }
-            if (ImGui::SliderFloat("Mod Base", &gameManager.terrainBase, 0.0f, 100.0f)) {
-                gameManager.generateTerrain();
-                gameManager.generateTrees();
+            ImGui::Checkbox("Random Seed On Start", &gameManager.randomSeed);
+            if (ImGui::SliderFloat("Frequency", &gameManager.terrain.frequency, 0.01f, 0.1f)) {
+                gameManager.generateWorld();
             }
-            if (ImGui::SliderFloat("Mod Peak", &gameManager.terrainPeak, 100.0f, 300.0f)) {
-                gameManager.generateTerrain();
-                gameManager.generateTrees();
+            if (ImGui::SliderFloat("Mod Base", &gameManager.terrain.terrainBase, 0.0f, 100.0f)) {
+                gameManager.generateWorld();
             }
-            if (ImGui::SliderFloat("Tree Frequency", &gameManager.treeFrequency, 0.01f, 1.0f)) {
-                gameManager.generateTerrain();
-                gameManager.generateTrees();
+            if (ImGui::SliderFloat("Mod Peak", &gameManager.terrain.terrainPeak, 100.0f, 300.0f)) {
+                gameManager.generateWorld();
             }
-            if (ImGui::SliderInt("Water Level", &gameManager.waterLevel, 0, 31)) {
-                gameManager.generateTerrain();
-                gameManager.generateTrees();
+            if (ImGui::SliderFloat("Tree Frequency", &gameManager.terrain.treeFrequency, 0.01f, 1.0f)) {
+                gameManager.generateWorld();
             }
+            if (ImGui::SliderInt("Water Level", &gameManager.terrain.waterLevel, 0, 31)) {
+                gameManager.generateWorld();
+            }
+
+            ImGui::SliderInt("Block Update Budget", &gameManager.blockUpdateBudget, 1, 16384);
+            ImGui::Text("Pending Block Updates: %zu", gameManager.getBlockScheduler().getPendingCount());
 
             const vec2 playerPos = gameManager.getPlayer()->position;
             const vec2 playerVel = gameManager.getPlayer()->velocity;
@@ -176,8 +275,41 @@ public:
     }
 };
 
-int main() {
+int main(const int argc, char **argv) {
+    // --cook converts meshes and textures to their cooked formats ahead of time, otherwise they are cooked on first use
+    if (argc > 1 && std::string_view(argv[1]) == "--cook") {
+        bool cooked = true;
+        const auto cookAll = [&](const char *directory, const char *extension,
+                                 bool (*cook)(const std::filesystem::path &)) {
+            for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+                if (entry.path().extension() != extension) continue;
+                const bool success = cook(entry.path());
+                printf("%s %s\n", success ? "Cooked" : "Failed to cook", entry.path().string().c_str());
+                cooked &= success;
+            }
+        };
+        cookAll("assets/meshes", ".obj", CookedMesh::cook);
+        cookAll("assets/textures", ".png", CookedTexture::cook);
+        return cooked ? 0 : 1;
+    }
+
     MainApp app;
+    // --trace[=seconds] captures the first frames after loading to trace.json
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--trace") app.startTraceAfterLoading(MainApp::defaultTraceSeconds);
+        else if (arg.starts_with("--trace=")) {
+            const std::string_view value = arg.substr(8);
+            double seconds = 0.0;
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), seconds);
+            if (error != std::errc() || end != value.data() + value.size() || !(seconds > 0.0)) {
+                fprintf(stderr, "Invalid trace length \"%.*s\", expected seconds, e.g. --trace=2.5\n",
+                        static_cast<int>(value.size()), value.data());
+                return 1;
+            }
+            app.startTraceAfterLoading(seconds);
+        } else if (arg == "--decode-textures") Texture2D::softwareDecode = true; // test the fallback without S3TC
+    }
     app.run();
     return 0;
 }
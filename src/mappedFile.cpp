@@ -0,0 +1,88 @@
+#include "mappedFile.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace arcader {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this == &other) return *this;
+        close();
+        bytes = std::exchange(other.bytes, nullptr);
+        length = std::exchange(other.length, 0);
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::filesystem::path &path) {
+        close();
+        const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        // The view keeps the mapping and the file alive, both handles can be closed right away
+        const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+        const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) return false;
+        bytes = static_cast<const std::byte *>(view);
+        length = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (bytes) UnmapViewOfFile(bytes);
+        bytes = nullptr;
+        length = 0;
+    }
+#else
+    bool MappedFile::open(const std::filesystem::path &path) {
+        close();
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+        struct stat info{};
+        if (fstat(file, &info) != 0 || info.st_size == 0) {
+            ::close(file);
+            return false;
+        }
+        // The mapping keeps the file alive, the descriptor can be closed right away
+        void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (view == MAP_FAILED) return false;
+        bytes = static_cast<const std::byte *>(view);
+        length = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (bytes) munmap(const_cast<std::byte *>(bytes), length);
+        bytes = nullptr;
+        length = 0;
+    }
+#endif
+
+} // arcader
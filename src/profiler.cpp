@@ -0,0 +1,193 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+#include <string_view>
+
+#include <framework/imguiutil.hpp>
+
+namespace arcader {
+
+    namespace {
+        double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        ImU32 scopeColor(const char *name) {
+            const size_t hash = std::hash<std::string_view>{}(name);
+            return ImColor::HSV(static_cast<float>(hash % 360) / 360.0f, 0.55f, 0.7f);
+        }
+    }
+
+    Profiler &Profiler::get() {
+        // GL queries are intentionally not deleted, the context is already gone when this is destroyed
+        static Profiler profiler;
+        return profiler;
+    }
+
+    void Profiler::beginFrame(const int state) {
+        const auto now = Clock::now();
+        if (started) {
+            Frame &done = frames[current];
+            done.cpuMs = std::chrono::duration<double, std::milli>(now - done.start).count();
+            timestamp(); // end of the frame on the GPU
+            done.pending = true;
+            current = (current + 1) % FRAME_LATENCY;
+        }
+        started = true;
+
+        Frame &frame = frames[current];
+        if (frame.pending) resolve(frame);
+        frame.samples.clear();
+        frame.usedQueries = 0;
+        frame.start = now;
+        frame.state = state;
+        depth = 0;
+        timestamp(); // start of the frame on the GPU, origin of all GPU times
+    }
+
+    size_t Profiler::begin(const char *name, const bool gpu) {
+        if (!started) return SIZE_MAX;
+        Frame &frame = frames[current];
+        ProfileSample sample{name, depth++, millisecondsSince(frame.start), 0.0};
+        if (gpu) sample.queryBegin = timestamp();
+        frame.samples.push_back(sample);
+        return frame.samples.size() - 1;
+    }
+
+    void Profiler::end(const size_t handle) {
+        Frame &frame = frames[current];
+        if (handle >= frame.samples.size()) return;
+        --depth;
+        ProfileSample &sample = frame.samples[handle];
+        sample.cpuEnd = millisecondsSince(frame.start);
+        if (sample.queryBegin >= 0) sample.queryEnd = timestamp();
+    }
+
+    GLsizei Profiler::timestamp() {
+        Frame &frame = frames[current];
+        if (frame.usedQueries == static_cast<GLsizei>(frame.queries.size())) {
+            constexpr GLsizei growth = 16;
+            frame.queries.resize(frame.queries.size() + growth);
+            glGenQueries(growth, &frame.queries[frame.queries.size() - growth]);
+        }
+        glQueryCounter(frame.queries[frame.usedQueries], GL_TIMESTAMP);
+        return frame.usedQueries++;
+    }
+
+    void Profiler::resolve(Frame &frame) {
+        frame.pending = false;
+
+        // Drop the GPU times instead of waiting if the GPU has not finished the frame yet
+        const auto available = [&](const GLsizei query) {
+            GLint result = 0;
+            glGetQueryObjectiv(frame.queries[query], GL_QUERY_RESULT_AVAILABLE, &result);
+            return result != 0;
+        };
+        if (frame.usedQueries >= 2 && available(0) && available(frame.usedQueries - 1)) {
+            GLuint64 origin = 0;
+            glGetQueryObjectui64v(frame.queries[0], GL_QUERY_RESULT, &origin);
+            const auto read = [&](const GLsizei query) {
+                GLuint64 time = 0;
+                glGetQueryObjectui64v(frame.queries[query], GL_QUERY_RESULT, &time);
+                return static_cast<double>(time - origin) * 1e-6;
+            };
+            for (auto &sample : frame.samples) {
+                if (sample.queryBegin < 0 || sample.queryEnd < 0) continue;
+                if (!available(sample.queryBegin) || !available(sample.queryEnd)) continue;
+                sample.gpuBegin = read(sample.queryBegin);
+                sample.gpuEnd = read(sample.queryEnd);
+            }
+            frame.gpuMs = read(frame.usedQueries - 1);
+        } else {
+            frame.gpuMs = -1.0;
+        }
+
+        // Add to the rolling history, scopes running several times per frame are summed up
+        historyIndex = (historyIndex + 1) % HISTORY_SIZE;
+        frameCpu[historyIndex] = static_cast<float>(frame.cpuMs);
+        frameGpu[historyIndex] = static_cast<float>(std::max(frame.gpuMs, 0.0));
+        for (auto &[name, history] : scopes) {
+            history.cpu[historyIndex] = 0.0f;
+            history.gpu[historyIndex] = 0.0f;
+        }
+        for (const auto &sample : frame.samples) {
+            auto it = scopes.find(sample.name);
+            if (it == scopes.end()) it = scopes.emplace(sample.name, ScopeHistory{}).first;
+            it->second.cpu[historyIndex] += static_cast<float>(sample.cpuEnd - sample.cpuBegin);
+            if (sample.gpuBegin >= 0.0) it->second.gpu[historyIndex] += static_cast<float>(sample.gpuEnd - sample.gpuBegin);
+        }
+
+        trace.addFrame(frame.start, frame.cpuMs, frame.gpuMs, frame.state, frame.samples);
+
+        latest.samples.assign(frame.samples.begin(), frame.samples.end());
+        latest.cpuMs = frame.cpuMs;
+        latest.gpuMs = frame.gpuMs;
+    }
+
+    void Profiler::buildImGui() const {
+        ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+        // Frame times of the history
+        const int offset = (historyIndex + 1) % HISTORY_SIZE;
+        char overlay[32];
+        std::snprintf(overlay, sizeof(overlay), "CPU %.2f ms", latest.cpuMs);
+        ImGui::PlotLines("##cpu", frameCpu.data(), HISTORY_SIZE, offset, overlay, 0.0f, 33.3f, ImVec2(600, 50));
+        if (latest.gpuMs >= 0.0) std::snprintf(overlay, sizeof(overlay), "GPU %.2f ms", latest.gpuMs);
+        else std::snprintf(overlay, sizeof(overlay), "GPU n/a");
+        ImGui::PlotLines("##gpu", frameGpu.data(), HISTORY_SIZE, offset, overlay, 0.0f, 33.3f, ImVec2(600, 50));
+
+        // Flame view of the latest resolved frame, CPU rows on top, GPU rows below
+        int maxDepth = 0;
+        for (const auto &sample : latest.samples) maxDepth = std::max(maxDepth, sample.depth);
+        constexpr float width = 600.0f;
+        constexpr float rowHeight = 18.0f;
+        const double span = std::max({latest.cpuMs, latest.gpuMs, 1000.0 / 60.0});
+        const auto scale = static_cast<float>(width / span);
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImDrawList *drawList = ImGui::GetWindowDrawList();
+
+        const auto bar = [&](const double begin, const double end, const int row, const char *name) {
+            const ImVec2 min(origin.x + static_cast<float>(begin) * scale, origin.y + static_cast<float>(row) * rowHeight);
+            const ImVec2 max(std::max(origin.x + static_cast<float>(end) * scale, min.x + 1.0f), min.y + rowHeight - 1.0f);
+            drawList->AddRectFilled(min, max, scopeColor(name));
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32_WHITE, name);
+            drawList->PopClipRect();
+            if (ImGui::IsMouseHoveringRect(min, max)) ImGui::SetTooltip("%s: %.3f ms", name, end - begin);
+        };
+        for (const auto &sample : latest.samples) {
+            bar(sample.cpuBegin, sample.cpuEnd, sample.depth, sample.name);
+            if (sample.gpuBegin >= 0.0) bar(sample.gpuBegin, sample.gpuEnd, maxDepth + 1 + sample.depth, sample.name);
+        }
+        ImGui::Dummy(ImVec2(width, rowHeight * static_cast<float>(2 * (maxDepth + 1))));
+
+        // Average time of every scope over the history
+        if (ImGui::BeginTable("Scopes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+            ImGui::TableSetupColumn("Scope");
+            ImGui::TableSetupColumn("CPU ms");
+            ImGui::TableSetupColumn("GPU ms");
+            ImGui::TableHeadersRow();
+
+            std::vector<const std::pair<const std::string, ScopeHistory> *> sorted;
+            for (const auto &entry : scopes) sorted.push_back(&entry);
+            std::ranges::sort(sorted, {}, [](const auto *entry) -> const std::string & { return entry->first; });
+            for (const auto *entry : sorted) {
+                const auto &history = entry->second;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(entry->first.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", std::accumulate(history.cpu.begin(), history.cpu.end(), 0.0f) / HISTORY_SIZE);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", std::accumulate(history.gpu.begin(), history.gpu.end(), 0.0f) / HISTORY_SIZE);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::End();
+    }
+
+} // arcader
@@ -0,0 +1,281 @@
+#include "programCache.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+#include "cookCache.hpp"
+#include "mappedFile.hpp"
+#include "random.hpp"
+#include "uniformCache.hpp"
+
+namespace arcader {
+
+    namespace {
+        /**
+         * Header of a cached program binary, followed by the binary itself.
+         */
+        struct BinaryHeader {
+            char magic[4];
+            uint32_t version;
+            uint32_t format; // binary format reported by glGetProgramBinary
+            uint32_t length;
+        };
+
+        constexpr char MAGIC[4] = {'A', 'P', 'R', 'G'};
+
+        uint64_t hashString(const GLenum name) {
+            const auto *value = reinterpret_cast<const char *>(glGetString(name));
+            return value ? CookCache::hashBytes(value, std::strlen(value)) : 0;
+        }
+
+        /**
+         * @return Modification time of the file, the minimum if it can not be read (e.g. while an editor replaces it)
+         */
+        std::filesystem::file_time_type modifiedTime(const std::filesystem::path &path) {
+            std::error_code error;
+            const auto time = std::filesystem::last_write_time(path, error);
+            return error ? std::filesystem::file_time_type::min() : time;
+        }
+
+        bool isLinked(const GLuint handle) {
+            GLint linked = GL_FALSE;
+            if (handle) glGetProgramiv(handle, GL_LINK_STATUS, &linked);
+            return linked == GL_TRUE;
+        }
+
+        struct ActiveUniform {
+            std::string name; // arrays are reported as name[0]
+            GLenum type;
+            GLint size;
+        };
+
+        std::vector<ActiveUniform> activeUniforms(const GLuint handle) {
+            GLint count = 0;
+            GLint maxLength = 0;
+            glGetProgramiv(handle, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+            std::vector<ActiveUniform> uniforms;
+            std::string name(static_cast<size_t>(std::max(maxLength, 1)), '\0');
+            for (GLint i = 0; i < count; ++i) {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(handle, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.data());
+                uniforms.push_back({name.substr(0, static_cast<size_t>(length)), type, size});
+            }
+            return uniforms;
+        }
+
+        /**
+         * Copy one uniform value of the source program into the target program, which has to be in use.
+         */
+        void copyUniform(const GLuint source, const GLint from, const GLint to, const GLenum type) {
+            GLfloat floats[16];
+            GLint ints[4];
+            switch (type) {
+                case GL_FLOAT: glGetUniformfv(source, from, floats); glUniform1fv(to, 1, floats); break;
+                case GL_FLOAT_VEC2: glGetUniformfv(source, from, floats); glUniform2fv(to, 1, floats); break;
+                case GL_FLOAT_VEC3: glGetUniformfv(source, from, floats); glUniform3fv(to, 1, floats); break;
+                case GL_FLOAT_VEC4: glGetUniformfv(source, from, floats); glUniform4fv(to, 1, floats); break;
+                case GL_FLOAT_MAT3: glGetUniformfv(source, from, floats);
+                    glUniformMatrix3fv(to, 1, GL_FALSE, floats); break;
+                case GL_FLOAT_MAT4: glGetUniformfv(source, from, floats);
+                    glUniformMatrix4fv(to, 1, GL_FALSE, floats); break;
+                case GL_INT_VEC2:
+                case GL_BOOL_VEC2: glGetUniformiv(source, from, ints); glUniform2iv(to, 1, ints); break;
+                case GL_INT_VEC3:
+                case GL_BOOL_VEC3: glGetUniformiv(source, from, ints); glUniform3iv(to, 1, ints); break;
+                case GL_INT_VEC4:
+                case GL_BOOL_VEC4: glGetUniformiv(source, from, ints); glUniform4iv(to, 1, ints); break;
+                case GL_INT:
+                case GL_BOOL:
+                case GL_SAMPLER_2D:
+                case GL_SAMPLER_3D:
+                case GL_SAMPLER_CUBE:
+                case GL_SAMPLER_2D_SHADOW:
+                case GL_SAMPLER_2D_ARRAY:
+                case GL_SAMPLER_2D_ARRAY_SHADOW: glGetUniformiv(source, from, ints); glUniform1iv(to, 1, ints); break;
+                default: break; // not used by any shader, starts out zero
+            }
+        }
+
+        /**
+         * Carry the values of the default block uniforms (including sampler units) the programs have in common
+         * over to the target, uniforms that changed their type start out zero.
+         */
+        void copyUniforms(const GLuint source, const GLuint target) {
+            const std::vector<ActiveUniform> previous = activeUniforms(source);
+            GLint current = 0;
+            glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+            glUseProgram(target);
+            for (const auto &[name, type, size]: activeUniforms(target)) {
+                const auto match = std::find_if(previous.begin(), previous.end(), [&](const ActiveUniform &uniform) {
+                    return uniform.name == name && uniform.type == type;
+                });
+                if (match == previous.end()) continue;
+
+                const std::string base = size > 1 ? name.substr(0, name.rfind('[')) : name;
+                for (GLint element = 0; element < std::min(size, match->size); ++element) {
+                    const std::string elementName = size > 1 ? base + "[" + std::to_string(element) + "]" : name;
+                    const GLint from = glGetUniformLocation(source, elementName.c_str());
+                    const GLint to = glGetUniformLocation(target, elementName.c_str());
+                    if (from >= 0 && to >= 0) copyUniform(source, from, to, type); // block members have no location
+                }
+            }
+            glUseProgram(static_cast<GLuint>(current));
+        }
+    }
+
+    ProgramCache &ProgramCache::get() {
+        static ProgramCache cache;
+        return cache;
+    }
+
+    void ProgramCache::load(Program &program, const std::filesystem::path &vertexPath,
+                            const std::filesystem::path &fragmentPath) {
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+
+        const auto key = cacheKey(vertexPath, fragmentPath);
+        const bool cached = key && loadBinary(program, *key);
+        if (!cached) {
+            program.load(vertexPath.string(), fragmentPath.string());
+            if (key) storeBinary(program, *key);
+        }
+        watch(program, vertexPath, fragmentPath);
+
+        const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        loadTimes.push_back({vertexPath.string() + " + " + fragmentPath.string(), milliseconds, cached});
+    }
+
+    void ProgramCache::printReport() const {
+        double compiledTime = 0.0;
+        double cachedTime = 0.0;
+        for (const auto &[name, milliseconds, cached]: loadTimes) (cached ? cachedTime : compiledTime) += milliseconds;
+        printf("Shader programs: %.1f ms compiling, %.1f ms from cache\n", compiledTime, cachedTime);
+        for (const auto &[name, milliseconds, cached]: loadTimes) {
+            printf("  %-8s %8.2f ms  %s\n", cached ? "cached" : "compiled", milliseconds, name.c_str());
+        }
+    }
+
+    void ProgramCache::reloadChanged() {
+        const auto now = std::chrono::steady_clock::now();
+        if (now < nextPoll) return;
+        nextPoll = now + POLL_INTERVAL;
+
+        for (Watch &watch: watches) {
+            // A moved Program leaves the watch behind, its handle no longer matches (or is zero)
+            assert(watch.program->handle == watch.handle && "watched Program was moved after loading");
+            if (watch.program->handle != watch.handle) continue;
+            const auto vertexTime = modifiedTime(watch.vertexPath);
+            const auto fragmentTime = modifiedTime(watch.fragmentPath);
+            if (vertexTime == watch.vertexTime && fragmentTime == watch.fragmentTime) continue;
+            // Remember the new times first, a broken shader is only retried once it is saved again
+            watch.vertexTime = vertexTime;
+            watch.fragmentTime = fragmentTime;
+            if (reload(watch)) watch.handle = watch.program->handle;
+        }
+    }
+
+    void ProgramCache::watch(Program &program, const std::filesystem::path &vertexPath,
+                             const std::filesystem::path &fragmentPath) {
+        const auto existing = std::find_if(watches.begin(), watches.end(), [&](const Watch &watch) {
+            return watch.program == &program;
+        });
+        Watch &watch = existing != watches.end() ? *existing : watches.emplace_back();
+        watch = {&program, program.handle, vertexPath, fragmentPath, modifiedTime(vertexPath),
+                 modifiedTime(fragmentPath)};
+    }
+
+    bool ProgramCache::reload(const Watch &watch) {
+        const std::string name = watch.vertexPath.string() + " + " + watch.fragmentPath.string();
+        Program fresh;
+        try {
+            fresh.load(watch.vertexPath.string(), watch.fragmentPath.string());
+        } catch (const std::exception &exception) {
+            std::cerr << exception.what() << std::endl;
+        }
+        if (!isLinked(fresh.handle)) {
+            std::cerr << "Failed to reload " << name << ", keeping the previous program" << std::endl;
+            glDeleteProgram(fresh.handle);
+            fresh.handle = 0;
+            return false;
+        }
+
+        // Set up the new program completely before swapping it in, between two frames
+        Program &program = *watch.program;
+        if (program.handle) copyUniforms(program.handle, fresh.handle);
+        UniformCache::bindBlocks(fresh);
+        std::swap(program.handle, fresh.handle);
+        glDeleteProgram(fresh.handle);
+        fresh.handle = 0;
+
+        if (const auto key = cacheKey(watch.vertexPath, watch.fragmentPath)) storeBinary(program, *key);
+        std::cout << "Reloaded " << name << std::endl;
+        return true;
+    }
+
+    std::optional<uint64_t> ProgramCache::cacheKey(const std::filesystem::path &vertexPath,
+                                                   const std::filesystem::path &fragmentPath) {
+        if (!supported) {
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            supported = formats > 0;
+            driver = Random::hash(hashString(GL_VENDOR), hashString(GL_RENDERER), hashString(GL_VERSION));
+        }
+        if (!*supported) return std::nullopt;
+
+        const auto vertex = CookCache::hashFile(vertexPath);
+        const auto fragment = CookCache::hashFile(fragmentPath);
+        if (!vertex || !fragment) return std::nullopt;
+        return Random::hash(*vertex, *fragment, driver, VERSION);
+    }
+
+    bool ProgramCache::loadBinary(Program &program, const uint64_t key) const {
+        MappedFile file;
+        if (!file.open(CookCache::cookedPath(key, ".program"))) return false;
+        BinaryHeader header;
+        if (file.size() < sizeof(header)) return false;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+            header.length != file.size() - sizeof(header))
+            return false;
+
+        if (program.handle == 0) program.handle = glCreateProgram();
+        glProgramBinary(program.handle, header.format, file.data() + sizeof(header),
+                        static_cast<GLsizei>(header.length));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program.handle, GL_LINK_STATUS, &linked);
+        return linked == GL_TRUE;
+    }
+
+    void ProgramCache::storeBinary(const Program &program, const uint64_t key) const {
+        GLint linked = GL_FALSE;
+        GLint length = 0;
+        glGetProgramiv(program.handle, GL_LINK_STATUS, &linked);
+        glGetProgramiv(program.handle, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (linked != GL_TRUE || length <= 0) return; // failed programs are compiled again next time
+
+        BinaryHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        std::vector<std::byte> bytes(sizeof(header) + static_cast<size_t>(length));
+        GLsizei written = 0;
+        GLenum format = 0;
+        glGetProgramBinary(program.handle, length, &written, &format, bytes.data() + sizeof(header));
+        if (written <= 0) return;
+        header.format = format;
+        header.length = static_cast<uint32_t>(written);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        bytes.resize(sizeof(header) + static_cast<size_t>(written));
+        CookCache::write(CookCache::cookedPath(key, ".program"), bytes);
+    }
+
+} // arcader
@@ -0,0 +1,279 @@
+#include "staticMesh.hpp"
+
+#include "cookedMesh.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace arcader {
+
+    namespace {
+        struct CornerKey {
+            int position;
+            int texCoord;
+            int normal;
+
+            bool operator==(const CornerKey &) const = default;
+        };
+
+        struct CornerHash {
+            size_t operator()(const CornerKey &key) const {
+                size_t hash = static_cast<size_t>(key.position) * 73856093u;
+                hash ^= static_cast<size_t>(key.texCoord) * 19349663u;
+                hash ^= static_cast<size_t>(key.normal) * 83492791u;
+                return hash;
+            }
+        };
+
+        /**
+         * Parse one OBJ index, negative indices count from the end. Moves the cursor behind the number.
+         * @return Zero based index, -1 if absent
+         */
+        int parseIndex(const char *&cursor, const size_t count) {
+            char *end;
+            const long value = std::strtol(cursor, &end, 10);
+            if (end == cursor) return -1;
+            cursor = end;
+            return static_cast<int>(value < 0 ? static_cast<long>(count) + value : value - 1);
+        }
+    }
+
+    MeshBounds MeshData::computeBounds() const {
+        if (vertices.empty()) return {};
+        MeshBounds bounds{vertices.front().position, vertices.front().position};
+        for (const MeshVertex &vertex: vertices) {
+            bounds.min = glm::min(bounds.min, vertex.position);
+            bounds.max = glm::max(bounds.max, vertex.position);
+        }
+        return bounds;
+    }
+
+    StaticMesh::~StaticMesh() {
+        release();
+    }
+
+    StaticMesh::StaticMesh(StaticMesh &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    StaticMesh &StaticMesh::operator=(StaticMesh &&other) noexcept {
+        if (this == &other) return *this;
+        release();
+        vao = std::exchange(other.vao, 0);
+        vbo = std::exchange(other.vbo, 0);
+        ebo = std::exchange(other.ebo, 0);
+        indexCount = std::exchange(other.indexCount, 0);
+        instanceAttributes = std::exchange(other.instanceAttributes, false);
+        indexType = other.indexType;
+        bounds = other.bounds;
+        return *this;
+    }
+
+    void StaticMesh::release() {
+        if (vao == 0) return;
+        glDeleteBuffers(1, &ebo);
+        glDeleteBuffers(1, &vbo);
+        glDeleteVertexArrays(1, &vao);
+        vao = vbo = ebo = 0;
+        indexCount = 0;
+        instanceAttributes = false;
+    }
+
+    bool StaticMesh::parseObj(const std::filesystem::path &path, MeshData &data) {
+        std::ifstream file(path);
+        if (!file) return false;
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        const std::string text = buffer.str();
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        std::unordered_map<CornerKey, GLuint, CornerHash> corners;
+        std::vector<GLuint> polygon;
+        auto &[vertices, indices] = data;
+        vertices.clear();
+        indices.clear();
+
+        size_t lineStart = 0;
+        while (lineStart < text.size()) {
+            size_t lineEnd = text.find('\n', lineStart);
+            if (lineEnd == std::string::npos) lineEnd = text.size();
+            const char *line = text.c_str() + lineStart;
+            lineStart = lineEnd + 1;
+
+            char *end;
+            if (line[0] == 'v' && line[1] == ' ') {
+                glm::vec3 &p = positions.emplace_back();
+                p.x = std::strtof(line + 2, &end);
+                p.y = std::strtof(end, &end);
+                p.z = std::strtof(end, &end);
+            } else if (line[0] == 'v' && line[1] == 't' && line[2] == ' ') {
+                glm::vec2 &t = texCoords.emplace_back();
+                t.x = std::strtof(line + 3, &end);
+                t.y = std::strtof(end, &end);
+            } else if (line[0] == 'v' && line[1] == 'n' && line[2] == ' ') {
+                glm::vec3 &n = normals.emplace_back();
+                n.x = std::strtof(line + 3, &end);
+                n.y = std::strtof(end, &end);
+                n.z = std::strtof(end, &end);
+            } else if (line[0] == 'f' && line[1] == ' ') {
+                // Corners are v, v/vt, v//vn or v/vt/vn, equal corners share a vertex
+                polygon.clear();
+                const char *cursor = line + 2;
+                const char *lineLimit = text.c_str() + lineEnd;
+                while (cursor < lineLimit) {
+                    while (cursor < lineLimit && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) ++cursor;
+                    if (cursor >= lineLimit) break;
+                    CornerKey key{parseIndex(cursor, positions.size()), -1, -1};
+                    if (key.position < 0) break;
+                    if (*cursor == '/') {
+                        ++cursor;
+                        if (*cursor != '/') key.texCoord = parseIndex(cursor, texCoords.size());
+                        if (*cursor == '/') {
+                            ++cursor;
+                            key.normal = parseIndex(cursor, normals.size());
+                        }
+                    }
+
+                    const auto [it, inserted] = corners.try_emplace(key, static_cast<GLuint>(vertices.size()));
+                    if (inserted) {
+                        MeshVertex &vertex = vertices.emplace_back();
+                        vertex.position = key.position < static_cast<int>(positions.size())
+                                              ? positions[key.position] : glm::vec3(0.0f);
+                        vertex.texCoord = key.texCoord >= 0 && key.texCoord < static_cast<int>(texCoords.size())
+                                              ? texCoords[key.texCoord] : glm::vec2(0.0f);
+                        vertex.normal = key.normal >= 0 && key.normal < static_cast<int>(normals.size())
+                                            ? normals[key.normal] : glm::vec3(0.0f);
+                    }
+                    polygon.push_back(it->second);
+                }
+                for (size_t i = 2; i < polygon.size(); ++i) {
+                    indices.insert(indices.end(), {polygon[0], polygon[i - 1], polygon[i]});
+                }
+            }
+        }
+        return true;
+    }
+
+    void StaticMesh::load(const std::filesystem::path &path) {
+        CookedMesh cooked;
+        if (!cooked.load(path)) {
+            std::cerr << "Failed to load mesh at: " << path << std::endl;
+            return;
+        }
+        upload(cooked);
+    }
+
+    void StaticMesh::upload(const MeshData &data) {
+        const auto &[vertices, indices] = data;
+        bounds = data.computeBounds();
+        upload(vertices.data(), vertices.size(), indices.data(), sizeof(GLuint),
+               static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT);
+    }
+
+    void StaticMesh::upload(const CookedMesh &cooked) {
+        bounds = cooked.getBounds();
+        upload(cooked.getVertices(), static_cast<size_t>(cooked.getVertexCount()), cooked.getIndices(),
+               cooked.getIndexType() == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint),
+               cooked.getIndexCount(), cooked.getIndexType());
+    }
+
+    void StaticMesh::upload(const void *vertices, const size_t vertexCount, const void *indices,
+                            const size_t indexSize, const GLsizei count, const GLenum type) {
+        if (vao == 0) {
+            glGenVertexArrays(1, &vao);
+            glGenBuffers(1, &vbo);
+            glGenBuffers(1, &ebo);
+
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex),
+                                  reinterpret_cast<void *>(offsetof(MeshVertex, position)));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex),
+                                  reinterpret_cast<void *>(offsetof(MeshVertex, texCoord)));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex),
+                                  reinterpret_cast<void *>(offsetof(MeshVertex, normal)));
+
+            // Instance attributes stay disabled until the first instanced draw
+            for (GLuint attribute = 3; attribute <= 7; ++attribute) glVertexAttribDivisor(attribute, 1);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); // Element buffer binding is part of the VAO state
+        } else {
+            glBindVertexArray(vao);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexCount * sizeof(MeshVertex)), vertices,
+                     GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(count * indexSize), indices, GL_STATIC_DRAW);
+        indexCount = count;
+        indexType = type;
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void StaticMesh::draw() const {
+        if (indexCount == 0) return;
+        glBindVertexArray(vao);
+        glDrawElements(GL_TRIANGLES, indexCount, indexType, nullptr);
+        glBindVertexArray(0);
+    }
+
+    void StaticMesh::drawInstanced(const InstanceBuffer &instances) {
+        if (indexCount == 0 || instances.size() == 0) return;
+
+        // Only points the attributes at the buffer, GL 4.1 has no separate vertex buffer bindings
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, instances.handle);
+        for (GLuint column = 0; column < 4; ++column) {
+            glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstance),
+                                  reinterpret_cast<void *>(offsetof(MeshInstance, model) + column * sizeof(glm::vec4)));
+        }
+        glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(MeshInstance),
+                              reinterpret_cast<void *>(offsetof(MeshInstance, layer)));
+        if (!instanceAttributes) {
+            for (GLuint attribute = 3; attribute <= 7; ++attribute) glEnableVertexAttribArray(attribute);
+            instanceAttributes = true;
+        }
+
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, indexType, nullptr, instances.size());
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    InstanceBuffer::~InstanceBuffer() {
+        if (handle) glDeleteBuffers(1, &handle);
+    }
+
+    InstanceBuffer::InstanceBuffer(InstanceBuffer &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    InstanceBuffer &InstanceBuffer::operator=(InstanceBuffer &&other) noexcept {
+        if (this == &other) return *this;
+        if (handle) glDeleteBuffers(1, &handle);
+        handle = std::exchange(other.handle, 0);
+        count = std::exchange(other.count, 0);
+        return *this;
+    }
+
+    void InstanceBuffer::upload(const std::vector<MeshInstance> &instances) {
+        if (!handle) glGenBuffers(1, &handle);
+        count = static_cast<GLsizei>(instances.size());
+        glBindBuffer(GL_ARRAY_BUFFER, handle);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size() * sizeof(MeshInstance)),
+                     instances.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+} // arcader
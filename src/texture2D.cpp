@@ -0,0 +1,137 @@
+#include "texture2D.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include <framework/gl/texture.hpp> // stb_image
+
+#include "cookedTexture.hpp"
+
+// EXT_texture_compression_s3tc and EXT_texture_sRGB, not part of the core profile headers
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace arcader {
+
+    namespace {
+        /**
+         * Sampling of the bound texture: linear, trilinear if there are mip levels, repeating.
+         */
+        void setSampling(const GLint levels) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        }
+    }
+
+    DecodedImage DecodedImage::load(const std::filesystem::path &path) {
+        DecodedImage image;
+        int channels;
+        // Per-thread flag, the global one would race with other loaders
+        stbi_set_flip_vertically_on_load_thread(1);
+        unsigned char *data = stbi_load(path.string().c_str(), &image.width, &image.height, &channels, 4);
+        if (!data) {
+            std::cerr << "Failed to load image at: " << path << std::endl;
+            return {1, 1, {255, 0, 255, 255}};
+        }
+        image.pixels.assign(data, data + static_cast<size_t>(image.width) * image.height * 4);
+        stbi_image_free(data);
+        return image;
+    }
+
+    Texture2D::~Texture2D() {
+        if (handle) glDeleteTextures(1, &handle);
+    }
+
+    Texture2D::Texture2D(Texture2D &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    Texture2D &Texture2D::operator=(Texture2D &&other) noexcept {
+        if (this == &other) return *this;
+        if (handle) glDeleteTextures(1, &handle);
+        handle = std::exchange(other.handle, 0);
+        width = std::exchange(other.width, 0);
+        height = std::exchange(other.height, 0);
+        return *this;
+    }
+
+    void Texture2D::upload(const DecodedImage &image, const GLenum internalFormat, const GLint mipmaps) {
+        if (!handle) glGenTextures(1, &handle);
+        width = image.width;
+        height = image.height;
+
+        const int fullChain = std::bit_width(static_cast<unsigned>(std::max(width, height))) - 1;
+        const int levels = mipmaps == FULL_MIP_CHAIN ? fullChain : std::clamp(mipmaps, 0, fullChain);
+
+        glBindTexture(GL_TEXTURE_2D, handle);
+        glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, image.pixels.data());
+        setSampling(levels);
+        if (levels > 0) glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void Texture2D::upload(const CookedTexture &texture, const bool srgb, const GLint mipmaps) {
+        const auto &levels = texture.getLevels();
+        if (levels.empty()) return;
+        if (!handle) glGenTextures(1, &handle);
+        width = levels[0].width;
+        height = levels[0].height;
+
+        const int fullChain = static_cast<int>(levels.size()) - 1;
+        const int count = mipmaps == FULL_MIP_CHAIN ? fullChain : std::clamp(mipmaps, 0, fullChain);
+        const bool alpha = texture.getFormat() == CookedTexture::Format::BC3;
+
+        glBindTexture(GL_TEXTURE_2D, handle);
+        if (supportsCompression()) {
+            const GLenum format = alpha
+                                      ? (srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+                                      : (srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+            for (int level = 0; level <= count; ++level) {
+                const auto &[levelWidth, levelHeight, blocks, size] = levels[level];
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, format, levelWidth, levelHeight, 0,
+                                       static_cast<GLsizei>(size), blocks);
+            }
+        } else {
+            for (int level = 0; level <= count; ++level) {
+                const DecodedImage decoded = texture.decode(static_cast<size_t>(level));
+                glTexImage2D(GL_TEXTURE_2D, level, srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, decoded.width, decoded.height, 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, decoded.pixels.data());
+            }
+        }
+        setSampling(count);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    bool Texture2D::supportsCompression() {
+        static const bool supported = [] {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            for (GLint i = 0; i < count; ++i) {
+                const auto *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+                if (name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) return true;
+            }
+            return false;
+        }();
+        return supported && !softwareDecode;
+    }
+
+    void Texture2D::bindTextureUnit(const GLuint unit) const {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, handle);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+} // arcader
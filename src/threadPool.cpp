@@ -0,0 +1,53 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+namespace arcader {
+
+    ThreadPool::ThreadPool(unsigned threadCount) {
+        threadCount = std::max(1u, threadCount);
+        workers.reserve(threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (auto &worker: workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::submit(std::function<void()> job) {
+        {
+            std::lock_guard lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        condition.notify_one();
+    }
+
+    unsigned ThreadPool::defaultThreadCount() {
+        const unsigned cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 1;
+    }
+
+    void ThreadPool::workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping && jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+} // arcader
@@ -0,0 +1,79 @@
+#include "traceWriter.hpp"
+
+#include <cstdio>
+
+#include "profiler.hpp"
+
+namespace arcader {
+
+    TraceWriter::~TraceWriter() {
+        if (writer.joinable()) writer.join();
+    }
+
+    void TraceWriter::start(std::filesystem::path path, const double seconds) {
+        if (capturing) return;
+        if (writing) {
+            printf("Previous trace is still being written, capture skipped\n");
+            return;
+        }
+        if (writer.joinable()) writer.join(); // already done writing, does not block
+        this->path = std::move(path);
+        this->seconds = seconds;
+        origin = std::chrono::steady_clock::now();
+        events.clear();
+        events.reserve(1 << 16); // a few seconds of frames, so capturing does not reallocate
+        capturing = true;
+        printf("Capturing %.1f s trace to %s\n", seconds, this->path.string().c_str());
+    }
+
+    void TraceWriter::addFrame(const std::chrono::steady_clock::time_point start, const double cpuMs, const double gpuMs,
+                               const int state, const std::vector<ProfileSample> &samples) {
+        if (!capturing || start < origin) return;
+
+        const double frameStart = std::chrono::duration<double, std::micro>(start - origin).count();
+        events.push_back({"Frame", frameStart, cpuMs * 1000.0, 1, state});
+        if (gpuMs >= 0.0) events.push_back({"GPU Frame", frameStart, gpuMs * 1000.0, 2, state});
+        for (const auto &sample : samples) {
+            events.push_back({sample.name, frameStart + sample.cpuBegin * 1000.0,
+                              (sample.cpuEnd - sample.cpuBegin) * 1000.0, 1, state});
+            if (sample.gpuBegin < 0.0) continue;
+            events.push_back({sample.name, frameStart + sample.gpuBegin * 1000.0,
+                              (sample.gpuEnd - sample.gpuBegin) * 1000.0, 2, state});
+        }
+
+        if (frameStart + cpuMs * 1000.0 >= seconds * 1e6) finish();
+    }
+
+    void TraceWriter::finish() {
+        capturing = false;
+        writing = true;
+        writer = std::thread([this, path = path, events = std::move(events)] {
+            write(path, events);
+            writing = false;
+        });
+        events = {};
+    }
+
+    void TraceWriter::write(const std::filesystem::path &path, const std::vector<Event> &events) {
+        FILE *file = std::fopen(path.string().c_str(), "w");
+        if (!file) {
+            fprintf(stderr, "Failed to write trace %s\n", path.string().c_str());
+            return;
+        }
+
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+        std::fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n", file);
+        std::fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}", file);
+        for (const auto &event : events) {
+            std::fprintf(file,
+                         ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":1,\"tid\":%d,\"args\":{\"state\":%d}}",
+                         event.name, event.thread == 1 ? "cpu" : "gpu", event.timestamp, event.duration,
+                         event.thread, event.state);
+        }
+        std::fputs("\n]}\n", file);
+        std::fclose(file);
+        printf("Trace written to %s (%zu events)\n", path.string().c_str(), events.size());
+    }
+
+} // arcader
@@ -0,0 +1,45 @@
+#include "uniformCache.hpp"
+
+#include <cstring>
+
+#include "uniformBuffer.hpp"
+
+namespace arcader {
+
+    UniformCache::UniformCache(const Program &program) : program(&program), handle(program.handle) {
+        bindBlocks(program);
+    }
+
+    void UniformCache::bindBlocks(const Program &program) {
+        constexpr std::pair<const char *, UniformBlock> blocks[] = {
+            {"Camera", UniformBlock::CAMERA},
+            {"Lighting", UniformBlock::LIGHTING},
+            {"Retro", UniformBlock::RETRO},
+        };
+        for (const auto &[name, binding] : blocks) {
+            const GLuint index = glGetUniformBlockIndex(program.handle, name);
+            if (index != GL_INVALID_INDEX) glUniformBlockBinding(program.handle, index, static_cast<GLuint>(binding));
+        }
+    }
+
+    GLint UniformCache::location(const char *name) {
+        if (!program) return -1;
+        if (program->handle != handle) {
+            handle = program->handle;
+            locations.clear();
+        }
+        for (const auto &[key, location] : locations) {
+            if (key == name) return location;
+        }
+        // Same name from another translation unit, remember this pointer too
+        for (const auto &[key, location] : locations) {
+            if (std::strcmp(key, name) != 0) continue;
+            locations.emplace_back(name, location);
+            return location;
+        }
+        const GLint location = glGetUniformLocation(handle, name);
+        locations.emplace_back(name, location);
+        return location;
+    }
+
+} // arcader